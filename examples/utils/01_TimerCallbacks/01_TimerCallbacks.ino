@@ -0,0 +1,88 @@
+/*************************************************************
+ * InstantIoT — Utils 01: Timer callbacks
+ *
+ * Use case: one periodic job per sensor without one global
+ *           function per sensor, and the cost of each style
+ *
+ * Callback styles (all without heap allocation):
+ *   timers.every(ms, fn)            plain void fn()
+ *   timers.every(ms, fn, &ctx)      void fn(void*) + user pointer
+ *   timers.every(ms, [i]{ ... })    capturing lambda, stored inline
+ *                                   (INSTANT_TIMER_INLINE_SIZE bytes)
+ *
+ * Benchmark: 16 timers due on every run(), N runs per style,
+ * prints the average cost of one firing (run() loop included).
+ *
+ * Board : any (no network needed)
+ *************************************************************/
+
+#include <utils/InstantIoTTimer.hpp>
+
+const int SENSOR_COUNT = 16;
+const uint32_t RUNS    = 2000;
+
+struct Sensor {
+    uint8_t  index;
+    uint32_t reads;
+};
+
+Sensor sensors[SENSOR_COUNT];
+volatile uint32_t plainReads = 0;
+
+void readPlain() {
+    plainReads++;
+}
+
+void readSensor(void* ctx) {
+    Sensor* s = static_cast<Sensor*>(ctx);
+    s->reads++;
+}
+
+// Every timer is due at each run(): millis() moves forward between
+// runs, the interval is 1 ms
+template<typename Setup>
+void bench(const char* name, Setup setup) {
+    InstantTimer timers;
+    setup(timers);
+
+    uint32_t busy = 0;
+    for (uint32_t r = 0; r < RUNS; r++) {
+        delay(1);
+        uint32_t t0 = micros();
+        timers.run();
+        busy += micros() - t0;
+    }
+
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print((float)busy * 1000.0f / (RUNS * SENSOR_COUNT), 1);
+    Serial.println(" ns per firing");
+}
+
+void setup() {
+    delay(2000);
+    Serial.begin(115200);
+    Serial.println("=== Timer callbacks benchmark ===");
+
+    for (int i = 0; i < SENSOR_COUNT; i++) sensors[i].index = i;
+
+    bench("Function pointer", [](InstantTimer& t) {
+        for (int i = 0; i < SENSOR_COUNT; i++) t.every(1, readPlain);
+    });
+
+    bench("Context pointer ", [](InstantTimer& t) {
+        for (int i = 0; i < SENSOR_COUNT; i++) t.every(1, readSensor, &sensors[i]);
+    });
+
+#if INSTANT_TIMER_INLINE_SIZE > 0
+    bench("Capturing lambda", [](InstantTimer& t) {
+        for (int i = 0; i < SENSOR_COUNT; i++) {
+            Sensor* s = &sensors[i];
+            t.every(1, [s] { s->reads++; });
+        }
+    });
+#endif
+}
+
+void loop() {
+}
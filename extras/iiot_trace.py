@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+iiot_trace.py — decode an InstantIoT binary trace (INSTANTIOT_TRACE).
+
+Accepts either capture:
+  - a raw serial capture containing `instant.dumpTrace(Serial)` output
+    ("IIOTTRC1" | COUNT u16 | 8-byte records), surrounded by any text;
+  - a raw iWidgets byte stream holding the TYPE_TRACE (0xF9) chunk frames
+    sent by `instant.sendTrace()`; the last complete trace is decoded.
+
+Prints one line per record, oldest first, with the time relative to the
+first record (micros() wrap-around is unwrapped).
+
+Usage:
+  python3 iiot_trace.py capture.bin
+  python3 iiot_trace.py --raw capture.bin      # timestamps as recorded
+"""
+
+import struct
+import sys
+
+MAGIC = b"IIOTTRC1"
+RECORD = struct.Struct("<IBBH")   # us, event, a, b
+TYPE_TRACE = 0xF9
+EV_TRACE_CHUNK = 0x01
+
+EVENTS = {
+    0x01: ("RX_FRAME",     "type=0x{a:02X} len={b}"),
+    0x02: ("TX_FRAME",     "type=0x{a:02X} len={b}"),
+    0x03: ("TX_SHORT",     "type=0x{a:02X} accepted={b}"),
+    0x04: ("DISPATCH",     "type=0x{a:02X} event=0x{b:02X}"),
+    0x05: ("DISPATCH_END", "type=0x{a:02X} took={b}us"),
+    0x06: ("DECODE_ERROR", "len={b}"),
+    0x07: ("CRC_ERROR",    "body={b}"),
+    0x08: ("RX_OVERFLOW",  "dropped={b}"),
+    0x09: ("RESYNC",       "skipped={b}"),
+    0x0A: ("CONNECT",      ""),
+    0x0B: ("DISCONNECT",   ""),
+    0x0C: ("RECONNECT",    "{link} attempt={b}"),
+    0x0D: ("RECONNECT_KO", "{link} attempt={b}"),
+    0x0E: ("COALESCED",    "len={b}"),
+}
+
+
+def records_from_dump(data):
+    """Records of the last stream dump in `data`, or None."""
+    pos = data.rfind(MAGIC)
+    if pos < 0:
+        return None
+    pos += len(MAGIC)
+    if pos + 2 > len(data):
+        return None
+    (count,) = struct.unpack_from("<H", data, pos)
+    pos += 2
+    count = min(count, (len(data) - pos) // RECORD.size)
+    return [RECORD.unpack_from(data, pos + i * RECORD.size) for i in range(count)]
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frames(data):
+    """(type, event, payload) of every valid frame in a raw byte stream."""
+    pos = 0
+    while pos + 5 <= len(data):
+        if data[pos] != 0xAA or data[pos + 1] != 0x01:
+            pos += 1
+            continue
+        (length,) = struct.unpack_from("<H", data, pos + 2)
+        end = pos + 4 + length + 1
+        body = data[pos + 4:pos + 4 + length]
+        if end > len(data) or crc8(body) != data[end - 1]:
+            pos += 1
+            continue
+        p = 1
+        for _ in range(body[0]):        # DEV_COUNT × (DEV_LEN + DEV)
+            p += 1 + body[p]
+        p += 1 + body[p]                # WID_LEN + WID
+        yield body[p], body[p + 1], body[p + 2:]
+        pos = end
+
+
+def records_from_frames(data):
+    """Records of the last complete sendTrace() in `data`, or None."""
+    chunks, last = {}, None
+    for typ, event, payload in frames(data):
+        if typ != TYPE_TRACE or event != EV_TRACE_CHUNK or len(payload) < 4:
+            continue
+        chunk, total = struct.unpack_from("<HH", payload)
+        if chunk == 0:
+            chunks = {}
+        chunks[chunk] = payload[4:]
+        if len(chunks) == total:
+            last = chunks
+    if last is None:
+        return None
+    body = b"".join(last[i] for i in sorted(last))
+    return [RECORD.unpack_from(body, i) for i in range(0, len(body) - RECORD.size + 1, RECORD.size)]
+
+
+def unwrap(records):
+    """64-bit timestamps: micros() wraps every ~71.6 min."""
+    out, base, last = [], 0, None
+    for us, event, a, b in records:
+        if last is not None and us < last:
+            base += 1 << 32
+        last = us
+        out.append((base + us, event, a, b))
+    return out
+
+
+def describe(event, a, b):
+    if event >= 0x80:
+        return "USER_%02X" % event, "a=%d b=%d" % (a, b)
+    name, fmt = EVENTS.get(event, ("0x%02X" % event, "a={a} b={b}"))
+    return name, fmt.format(a=a, b=b, link="tcp" if a else "wifi")
+
+
+def main(argv):
+    raw = "--raw" in argv
+    paths = [p for p in argv if p != "--raw"]
+    if len(paths) != 1:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    with open(paths[0], "rb") as f:
+        data = f.read()
+
+    records = records_from_dump(data)
+    if records is None:
+        records = records_from_frames(data)
+    if records is None:
+        print("no trace found in %s" % paths[0], file=sys.stderr)
+        return 1
+
+    records = unwrap(records)
+    t0 = records[0][0] if records else 0
+    prev = t0
+    for us, event, a, b in records:
+        name, detail = describe(event, a, b)
+        when = us if raw else us - t0
+        print("%12d us  +%-8d %-13s %s" % (when, us - prev, name, detail))
+        prev = us
+    print("%d records, %.3f ms" % (len(records), (prev - t0) / 1000.0))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
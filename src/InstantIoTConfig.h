@@ -149,6 +149,421 @@
     #define INSTANTIOT_WIDGETS_SEGSWITCH 1
 #endif
 
+// ============================================================
+// 💓 HEARTBEAT
+// ============================================================
+
+// Upper bound for setHeartbeatStretch(): the server declares the
+// device offline after heartbeat × 2.5 of silence
+#ifndef INSTANTIOT_HEARTBEAT_MAX_STRETCH_PCT
+    #define INSTANTIOT_HEARTBEAT_MAX_STRETCH_PCT 200
+#endif
+
+// ============================================================
+// 💤 IDLE
+// ============================================================
+
+// Longest single wait in InstantIoTCoreBase::idle() — bounds the
+// latency of transports that cannot wake on incoming data
+#ifndef INSTANTIOT_IDLE_MAX_MS
+    #define INSTANTIOT_IDLE_MAX_MS 50
+#endif
+
+// Enables enableLightSleep() (ESP32 automatic light sleep)
+#ifndef INSTANTIOT_IDLE_LIGHT_SLEEP
+    #define INSTANTIOT_IDLE_LIGHT_SLEEP 0
+#endif
+
+// ============================================================
+// 🔁 ACKED SESSION (server mode, opt-in)
+// ============================================================
+//
+// Keeps the last data frames in a RAM ring and replays the ones the
+// server did not receive after a TCP reconnect. Costs
+// INSTANTIOT_SESSION_RING_SIZE bytes of RAM when enabled.
+
+#ifndef INSTANTIOT_SESSION_RESUME
+    #define INSTANTIOT_SESSION_RESUME 0
+#endif
+
+#ifndef INSTANTIOT_SESSION_RING_SIZE
+    #define INSTANTIOT_SESSION_RING_SIZE 4096
+#endif
+
+// Time to wait for EV_SESSION_RESUME after a handshake before
+// assuming a server without acked-session support
+#ifndef INSTANTIOT_SESSION_RESUME_TIMEOUT_MS
+    #define INSTANTIOT_SESSION_RESUME_TIMEOUT_MS 3000
+#endif
+
+// ============================================================
+// 💾 OFFLINE QUEUE (store-and-forward, opt-in)
+// ============================================================
+//
+// While the transport is down, data frames are appended to a flash
+// log (core/InstantIoTOfflineLog.hpp) and drained after reconnect.
+// Flash footprint = SEGMENTS × SEGMENT_SIZE.
+
+#ifndef INSTANTIOT_OFFLINE_QUEUE
+    #define INSTANTIOT_OFFLINE_QUEUE 0
+#endif
+
+#ifndef INSTANTIOT_OFFLINE_SEGMENTS
+    #define INSTANTIOT_OFFLINE_SEGMENTS 8
+#endif
+
+#ifndef INSTANTIOT_OFFLINE_SEGMENT_SIZE
+    #define INSTANTIOT_OFFLINE_SEGMENT_SIZE 16384
+#endif
+
+// RAM staging of appends — flushed to flash in one write when full
+// or after FLUSH_MS (fewer, larger writes = less flash wear)
+#ifndef INSTANTIOT_OFFLINE_STAGING
+    #define INSTANTIOT_OFFLINE_STAGING INSTANT_TX_BUFFER_SIZE
+#endif
+
+#ifndef INSTANTIOT_OFFLINE_FLUSH_MS
+    #define INSTANTIOT_OFFLINE_FLUSH_MS 2000
+#endif
+
+// Drain rate after reconnect: BATCH frames every INTERVAL_MS
+#ifndef INSTANTIOT_OFFLINE_DRAIN_BATCH
+    #define INSTANTIOT_OFFLINE_DRAIN_BATCH 4
+#endif
+
+#ifndef INSTANTIOT_OFFLINE_DRAIN_INTERVAL_MS
+    #define INSTANTIOT_OFFLINE_DRAIN_INTERVAL_MS 10
+#endif
+
+// ============================================================
+// ⏲️ TIME SYNC (server mode, opt-in)
+// ============================================================
+//
+// NTP-style offset estimation against the server clock, used by
+// timestamped frames (AdvancedChartWidget::addPointAt).
+
+#ifndef INSTANTIOT_TIME_SYNC
+    #define INSTANTIOT_TIME_SYNC 0
+#endif
+
+// The estimate keeps the lowest-RTT sample among the last N
+#ifndef INSTANTIOT_TIMESYNC_SAMPLES
+    #define INSTANTIOT_TIMESYNC_SAMPLES 4
+#endif
+
+// ============================================================
+// 🏓 LATENCY PROBE (opt-in)
+// ============================================================
+//
+// TYPE_PING service frames + rolling RTT statistics per connection.
+
+#ifndef INSTANTIOT_PING
+    #define INSTANTIOT_PING 0
+#endif
+
+// Number of RTT samples kept (max 255)
+#ifndef INSTANTIOT_RTT_WINDOW
+    #define INSTANTIOT_RTT_WINDOW 32
+#endif
+
+// ============================================================
+// ⏲️ LOOP STATS (opt-in)
+// ============================================================
+//
+// micros()-based latency histograms per loop() phase
+// (core/InstantIoTLoopStats.hpp). ~1.3 KB RAM with the defaults.
+
+#ifndef INSTANTIOT_LOOP_STATS
+    #define INSTANTIOT_LOOP_STATS 0
+#endif
+
+// log2 buckets: the last one collects everything ≥ 2^(N-2) µs
+#ifndef INSTANTIOT_LOOP_STATS_BUCKETS
+    #define INSTANTIOT_LOOP_STATS_BUCKETS 20
+#endif
+
+// Widget types with their own dispatch histogram
+#ifndef INSTANTIOT_LOOP_STATS_TYPES
+    #define INSTANTIOT_LOOP_STATS_TYPES 6
+#endif
+
+// ============================================================
+// ⏱️ HANDLER PROFILING (opt-in)
+// ============================================================
+//
+// Call count / total / max / last execution time of every I<Widget>
+// block and legacy on*Event callback, plus a slow-handler hook.
+// See WidgetRegistry::dumpProfiles() and setSlowHandlerHook().
+
+#ifndef INSTANTIOT_HANDLER_PROFILING
+    #define INSTANTIOT_HANDLER_PROFILING 0
+#endif
+
+// ============================================================
+// 📊 LINK STATS (opt-in)
+// ============================================================
+//
+// Bytes / frames / error counters in the core, the codec and each
+// transport (core/InstantIoTLinkStats.hpp). IIOT_STAT(expr) compiles
+// to nothing when disabled.
+
+#ifndef INSTANTIOT_LINK_STATS
+    #define INSTANTIOT_LINK_STATS 0
+#endif
+
+#if INSTANTIOT_LINK_STATS
+    #define IIOT_STAT(expr) do { expr; } while(0)
+#else
+    #define IIOT_STAT(expr) do { } while(0)
+#endif
+
+// ============================================================
+// 🧵 TRACE (opt-in)
+// ============================================================
+//
+// Binary trace ring (core/InstantIoTTrace.hpp): RX/TX frames,
+// dispatch, errors, reconnects as 8-byte timestamped records.
+// Decoded on the host by extras/iiot_trace.py.
+
+#ifndef INSTANTIOT_TRACE
+    #define INSTANTIOT_TRACE 0
+#endif
+
+// Records kept (power of 2, 8 bytes each)
+#ifndef INSTANTIOT_TRACE_RECORDS
+    #define INSTANTIOT_TRACE_RECORDS 256
+#endif
+
+#if !INSTANTIOT_TRACE
+    #define IIOT_TRACE(event, a, b) do { } while(0)
+#endif
+
+// ============================================================
+// 🕹️ RX COALESCING (opt-in)
+// ============================================================
+//
+// Continuous input (joystick POSCHANGED, slider VALUECHANGING) queued
+// in the RX buffer is collapsed to the newest frame per widget within
+// one extractFrames() pass (core/InstantIoTCoalesce.hpp). Discrete
+// events (press, release, drag end...) are always dispatched, in order.
+
+#ifndef INSTANTIOT_RX_COALESCE
+    #define INSTANTIOT_RX_COALESCE 0
+#endif
+
+// Widgets coalesced at the same time (others are dispatched as is)
+#ifndef INSTANTIOT_RX_COALESCE_WIDGETS
+    #define INSTANTIOT_RX_COALESCE_WIDGETS 4
+#endif
+
+// Frames looked ahead per scan (multiple of 8)
+#ifndef INSTANTIOT_RX_COALESCE_FRAMES
+    #define INSTANTIOT_RX_COALESCE_FRAMES 64
+#endif
+
+// ============================================================
+// 🛰️ NETWORK TASK (opt-in, ESP32)
+// ============================================================
+//
+// Transport I/O, frame parsing and the core's periodic frames run in a
+// FreeRTOS task pinned to the protocol core. The sketch's loop() only
+// delivers the queued widget events; outgoing frames are handed to the
+// task through a TX ring. Implies INSTANTIOT_DEFERRED_DISPATCH.
+
+#ifndef INSTANTIOT_NETWORK_TASK
+    #define INSTANTIOT_NETWORK_TASK 0
+#endif
+
+#if INSTANTIOT_NETWORK_TASK && !defined(ESP32)
+    #error "INSTANTIOT_NETWORK_TASK needs an ESP32 (FreeRTOS SMP)"
+#endif
+
+// Core the task is pinned to (0 = PRO_CPU, where WiFi/lwIP run)
+#ifndef INSTANTIOT_NET_TASK_CORE
+    #define INSTANTIOT_NET_TASK_CORE 0
+#endif
+
+// Above the Arduino loop task (1), below the WiFi / lwIP tasks
+#ifndef INSTANTIOT_NET_TASK_PRIORITY
+    #define INSTANTIOT_NET_TASK_PRIORITY 2
+#endif
+
+#ifndef INSTANTIOT_NET_TASK_STACK
+    #define INSTANTIOT_NET_TASK_STACK 4096
+#endif
+
+// Longest sleep between two passes: bounds the TX latency on
+// transports that wake up on incoming data only (ms)
+#ifndef INSTANTIOT_NET_TASK_WAIT_MS
+    #define INSTANTIOT_NET_TASK_WAIT_MS 2
+#endif
+
+// ============================================================
+// 📤 TX QUEUE — sends from other tasks / ISRs (opt-in)
+// ============================================================
+//
+// sendBinary() may be called from any FreeRTOS task or ISR: outside the
+// I/O context the frame is encoded into a lock-free multi-producer queue
+// and written by the next loop() (core/InstantIoTTxQueue.hpp). Widget
+// state (send filters, shadows) is not locked: a widget's setters must
+// all be called from one context, never from two tasks, or a task and
+// an ISR. Context detection: ESP32 (task + ISR), AVR (ISR); elsewhere
+// every call is treated as the I/O context.
+
+#ifndef INSTANTIOT_TX_MPSC
+    #define INSTANTIOT_TX_MPSC 0
+#endif
+
+// Frames queued for the I/O context (power of 2, ~TX buffer each)
+#ifndef INSTANTIOT_TX_QUEUE_SIZE
+    #define INSTANTIOT_TX_QUEUE_SIZE 8
+#endif
+
+// ESP32: longest a task waits for a free slot when the queue is full,
+// so bursts longer than the queue are paced instead of lost. ISRs never
+// wait; a frame still without a slot is dropped and counted in
+// LinkStats::txQueueDrops. 0 = drop at once (ms)
+#ifndef INSTANTIOT_TX_QUEUE_WAIT_MS
+    #define INSTANTIOT_TX_QUEUE_WAIT_MS 20
+#endif
+
+// ============================================================
+// 📬 DEFERRED DISPATCH (opt-in)
+// ============================================================
+//
+// Frame parsing queues typed widget events instead of running the
+// handlers inline; loop() delivers them afterwards within a time budget
+// (core/InstantIoTEventQueue.hpp). When the queue is full, parsing
+// stops and frames wait in the RX buffer / the transport.
+
+#ifndef INSTANTIOT_DEFERRED_DISPATCH
+    #define INSTANTIOT_DEFERRED_DISPATCH INSTANTIOT_NETWORK_TASK
+#endif
+
+#if INSTANTIOT_NETWORK_TASK && !INSTANTIOT_DEFERRED_DISPATCH
+    #error "INSTANTIOT_NETWORK_TASK needs INSTANTIOT_DEFERRED_DISPATCH 1"
+#endif
+
+// Queued events (power of 2)
+#ifndef INSTANTIOT_EVENT_QUEUE_SIZE
+    #define INSTANTIOT_EVENT_QUEUE_SIZE 16
+#endif
+
+// Longest string payload kept per event (SegmentedSwitch ids)
+#ifndef INSTANTIOT_EVENT_TEXT_LENGTH
+    #define INSTANTIOT_EVENT_TEXT_LENGTH 64
+#endif
+
+// Default handler time per loop() (µs), see setDispatchBudget()
+#ifndef INSTANTIOT_DISPATCH_BUDGET_US
+    #define INSTANTIOT_DISPATCH_BUDGET_US 2000
+#endif
+
+// ============================================================
+// 🔄 STATE RESYNC (opt-in)
+// ============================================================
+//
+// Display widgets remember the last state the sketch set (gauge value
+// and range, LED color / brightness / on-off, text, bar values...) and
+// the core re-sends it after every connect edge, so a freshly connected
+// app shows the current state at once. Charts only with
+// INSTANTIOT_CHART_HISTORY (their series windows are restored).
+
+#ifndef INSTANTIOT_STATE_RESYNC
+    #define INSTANTIOT_STATE_RESYNC 0
+#endif
+
+// Longest text / Metric secondary payload kept per widget (bytes)
+#ifndef INSTANTIOT_RESYNC_TEXT_LENGTH
+    #define INSTANTIOT_RESYNC_TEXT_LENGTH 64
+#endif
+
+#if INSTANTIOT_RESYNC_TEXT_LENGTH > 255
+    #error "INSTANTIOT_RESYNC_TEXT_LENGTH must be <= 255"
+#endif
+
+// Bars kept per BarChart; a longer chart is not re-sent at all
+#ifndef INSTANTIOT_RESYNC_MAX_BARS
+    #define INSTANTIOT_RESYNC_MAX_BARS 16
+#endif
+
+// ============================================================
+// 📈 CHART HISTORY (opt-in)
+// ============================================================
+//
+// Per-series raw sample window + downsampling reducers in
+// AdvancedChartWidget (widgets/ChartSeries.hpp): push() samples at any
+// rate, the chart receives the reduced points on schedule.
+// RAM per chart ≈ SERIES × (HISTORY_POINTS × 4 + ~90) bytes.
+
+#ifndef INSTANTIOT_CHART_HISTORY
+    #define INSTANTIOT_CHART_HISTORY 0
+#endif
+
+// Buffered series per chart (others are sent unbuffered)
+#ifndef INSTANTIOT_CHART_SERIES
+    #define INSTANTIOT_CHART_SERIES 2
+#endif
+
+// Raw window per series (power of 2). For REDUCE_LTTB keep at least
+// two buckets: rate (Hz) × every (ms) / 500
+#ifndef INSTANTIOT_CHART_HISTORY_POINTS
+    #define INSTANTIOT_CHART_HISTORY_POINTS 64
+#endif
+
+// Points sent per series by restore() / resync (setSeriesData)
+#ifndef INSTANTIOT_CHART_RESTORE_POINTS
+    #define INSTANTIOT_CHART_RESTORE_POINTS 40
+#endif
+
+#ifndef INSTANTIOT_SERIES_ID_LENGTH
+    #define INSTANTIOT_SERIES_ID_LENGTH 16
+#endif
+
+// ============================================================
+// 📊 BAR CHART DELTAS (opt-in)
+// ============================================================
+//
+// BarChartWidget keeps the app's copy of its bars and setValues() sends
+// only the changed ones (bitmap + values, optionally quantized to 8/16
+// bits), picking the smallest encoding. +256 B RAM per bar chart.
+
+#ifndef INSTANTIOT_BAR_DELTA
+    #define INSTANTIOT_BAR_DELTA 0
+#endif
+
+// ============================================================
+// 📦 BATCHED UPDATES (opt-in)
+// ============================================================
+//
+// instant.beginUpdate() ... instant.commit(): widget sends in between
+// are buffered and leave as one TYPE_BATCH frame that the app applies
+// in a single UI update. The buffer is flushed early when full, so a
+// scene larger than one frame arrives as several consistent parts.
+// RAM: INSTANTIOT_BATCH_BUFFER_SIZE bytes.
+
+#ifndef INSTANTIOT_BATCH
+    #define INSTANTIOT_BATCH 0
+#endif
+
+// Records + headers per batch frame (capped by the TX buffer at run time)
+#ifndef INSTANTIOT_BATCH_BUFFER_SIZE
+    #define INSTANTIOT_BATCH_BUFFER_SIZE INSTANT_TX_BUFFER_SIZE
+#endif
+
+// ============================================================
+// 📝 TEXT DELTAS (opt-in)
+// ============================================================
+//
+// TextWidget keeps the text the app shows and setText() sends only the
+// changed range (EV_TEXT_APPEND / EV_TEXT_REPLACE) when that is smaller;
+// appendText() adds lines without resending the pane.
+// +256 B RAM per text widget.
+
+#ifndef INSTANTIOT_TEXT_DELTA
+    #define INSTANTIOT_TEXT_DELTA 0
+#endif
+
 // ============================================================
 // 🖨️ DEBUG MACROS
 // ============================================================
@@ -64,11 +64,26 @@ public:
     //
     // Recommended values: 2000–30000 ms.
     // Server clamps to [2s, 120s]. Value 0 disables (legacy mode).
+    // Heartbeats are only emitted after `intervalMs` without any
+    // other frame (see also setHeartbeatStretch()).
     void setHeartbeat(uint32_t intervalMs) {
         _transportImpl.setHeartbeat(intervalMs);
         InstantIoT::InstantIoTCoreBase::setHeartbeat(intervalMs);
     }
 
+    #if INSTANTIOT_SESSION_RESUME
+    // ----- Acked session — call before begin() -----
+    //
+    // Requires #define INSTANTIOT_SESSION_RESUME 1. A new random
+    // session id is drawn at each call (i.e. each boot): the server
+    // then knows whether it sees a reconnect or a fresh device.
+    void setAckedMode(bool enabled) {
+        uint32_t id = enabled ? (esp_random() | 1u) : 0;
+        _transportImpl.setSession(id);
+        InstantIoT::InstantIoTCoreBase::enableAckedSession(id);
+    }
+    #endif
+
     // ----- Connection: WiFi then TCP + handshake -----
     bool begin(const char* ssid, const char* pass) {
         _transportImpl.setCredentials(ssid, pass);
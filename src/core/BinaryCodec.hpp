@@ -30,6 +30,9 @@
 #include <string.h>
 #include "Codec.h"
 #include "../InstantIoTConfig.h"
+#if INSTANTIOT_TRACE
+#include "InstantIoTTrace.hpp"
+#endif
 
 namespace InstantIoT {
 
@@ -61,6 +64,43 @@ static const uint8_t TYPE_EMERGENCYBUTTON   = 0x11;
 // empty payload.
 static const uint8_t TYPE_HEARTBEAT         = 0xFE;
 
+// Service frame: acked session (TCP Server mode, opt-in via the
+// handshake "token:heartbeatMs:sessionId"). Data frames are numbered
+// implicitly by both sides in write order; service frames are not
+// counted. Never dispatched to user code.
+static const uint8_t TYPE_SESSION           = 0xFD;
+
+// Service frame: NTP-style clock offset estimation over the session
+// (4 timestamps: t1 device send, t2 server receive, t3 server send,
+// t4 device receive). Never dispatched to user code.
+static const uint8_t TYPE_TIMESYNC          = 0xFC;
+
+// Service frame: latency probe. Either side may ping, the other side
+// echoes the payload unchanged in a PONG. Never dispatched to user code.
+static const uint8_t TYPE_PING              = 0xFB;
+
+// Service frame: link health counters (LinkStats), Device → Server,
+// sent periodically when enabled. Never dispatched to user code.
+static const uint8_t TYPE_STATS             = 0xFA;
+
+// Service frame: dump of the binary trace ring, on demand
+// (InstantIoTCoreBase::sendTrace). Never dispatched to user code.
+static const uint8_t TYPE_TRACE             = 0xF9;
+
+// Batched update (beginUpdate() ... commit()): several widget sends
+// wrapped in one frame, applied by the app as a single UI update.
+// Not a service frame for the link: counted by the acked session and
+// kept by the offline queue like the data it carries.
+static const uint8_t TYPE_BATCH             = 0xF8;
+
+// Service types occupy the top of the TYPE space (0xF0..0xFF)
+static inline bool isServiceType(uint8_t typeCode) { return typeCode >= 0xF0; }
+
+// Frames carrying widget data (session numbering, offline queue)
+static inline bool isDataType(uint8_t typeCode) {
+    return !isServiceType(typeCode) || typeCode == TYPE_BATCH;
+}
+
 // ============================================================
 //  EVENT CODES — Device → App (0x01..0x0E)
 // ============================================================
@@ -70,18 +110,49 @@ static const uint8_t EV_SETRANGE           = 0x02;
 static const uint8_t EV_UPDATE             = 0x03;
 static const uint8_t EV_SETBRIGHTNESS      = 0x04;
 static const uint8_t EV_SETCOLOR           = 0x05;
+static const uint8_t EV_LED_ANIMATE        = 0x06;  // [kind:u8][period:u16][repeat:u8][param:u8][n:u8][r,g,b × n]
 static const uint8_t EV_SETSECONDARY       = 0x02;
 static const uint8_t EV_ADDPOINT           = 0x01;
 static const uint8_t EV_ADDTIMEDPOINT      = 0x02;
 static const uint8_t EV_CLEARSERIES        = 0x03;
 static const uint8_t EV_CLEARALL           = 0x04;
 static const uint8_t EV_SETSERIESDATA      = 0x05;
+static const uint8_t EV_SETTIMEBASE        = 0x06;  // [base:u64] server epoch ms
+static const uint8_t EV_ADDPOINT_TS        = 0x07;  // [sid][y:float][dt:u16] ms since time base
+static const uint8_t EV_ADDPOINTS          = 0x08;  // [sid][count:u16][y:float×count]
+static const uint8_t EV_ADDPOINTS_MULTI    = 0x09;  // [n:u8][sid×n][rows:u16][y:float×n×rows], row-major
 static const uint8_t EV_SETTEXT            = 0x01;
+static const uint8_t EV_TEXT_APPEND        = 0x02;  // [len:u8][bytes] added at the end
+static const uint8_t EV_TEXT_REPLACE       = 0x03;  // [start:u8][delete:u8][len:u8][bytes] replace a range
 
 // BarChart (TYPE_BARCHART)
 static const uint8_t EV_BAR_SETVALUES      = 0x01;  // [count:u8][values:float×count]
 static const uint8_t EV_BAR_SETBAR         = 0x02;  // [index:u8][value:float]
 static const uint8_t EV_BAR_CLEAR          = 0x03;  // no payload
+static const uint8_t EV_BAR_SETMASKED      = 0x04;  // [count:u8][mask:⌈count/8⌉ B, bit i = bar i][value:float × set bits]
+static const uint8_t EV_BAR_SETMASKED_Q    = 0x05;  // [count:u8][mask][bits:u8][min:float][max:float][code:u8|u16 × set bits]
+
+// Session (TYPE_SESSION)
+static const uint8_t EV_SESSION_ACK        = 0x01;  // Server → Device [count:u32] frames received so far
+static const uint8_t EV_SESSION_RESUME     = 0x02;  // Server → Device [count:u32] sent after each handshake
+static const uint8_t EV_SESSION_REPLAY     = 0x03;  // Device → Server [seq:u32]   seq of the next data frame
+
+// Time sync (TYPE_TIMESYNC)
+static const uint8_t EV_TIMESYNC_REQ       = 0x01;  // Device → Server [t1:u32] device ms
+static const uint8_t EV_TIMESYNC_RESP      = 0x02;  // Server → Device [t1:u32][t2:u64][t3:u64] server epoch ms
+
+// Latency probe (TYPE_PING)
+static const uint8_t EV_PING               = 0x01;  // [id:u16][t:u32] sender clock, opaque to the peer
+static const uint8_t EV_PONG               = 0x02;  // PING payload echoed
+
+// Link stats (TYPE_STATS)
+static const uint8_t EV_STATS_REPORT       = 0x01;  // [ver:u8][count:u8][u32 × count]
+
+// Trace dump (TYPE_TRACE)
+static const uint8_t EV_TRACE_CHUNK        = 0x01;  // [chunk:u16][chunks:u16][record:8B × n]
+
+// Batched update (TYPE_BATCH)
+static const uint8_t EV_BATCH_APPLY        = 0x01;  // [count:u8] then × count: [type][event][widLen][wid][len:u16][payload]
 
 // ============================================================
 //  COMMAND CODES — App → Device (0x10..0x1F)
@@ -111,6 +182,17 @@ static const uint8_t CMD_DRAGENDED         = 0x13;
 static const uint8_t CMD_EMERGENCY_TRIGGER = 0x01;  // no payload
 static const uint8_t CMD_EMERGENCY_RESET   = 0x02;  // no payload
 
+// Continuous input: a newer frame of the same widget makes the older
+// one obsolete (see INSTANTIOT_RX_COALESCE). Everything else is discrete.
+static inline bool isContinuousEvent(uint8_t typeCode, uint8_t eventCode) {
+    switch (typeCode) {
+        case TYPE_JOYSTICK: return eventCode == CMD_POSCHANGED;
+        case TYPE_HSLIDER:
+        case TYPE_VSLIDER:  return eventCode == CMD_VALUECHANGING;
+        default:            return false;
+    }
+}
+
 // ============================================================
 //  CRC-8/SMBUS poly=0x07
 // ============================================================
@@ -139,6 +221,29 @@ static uint16_t readU16LE(const uint8_t* buf) {
     return (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
 }
 
+static void writeU32LE(uint8_t* buf, uint32_t val) {
+    buf[0] = val & 0xFF;
+    buf[1] = (val >> 8)  & 0xFF;
+    buf[2] = (val >> 16) & 0xFF;
+    buf[3] = (val >> 24) & 0xFF;
+}
+
+static uint32_t readU32LE(const uint8_t* buf) {
+    return (uint32_t)buf[0]
+         | ((uint32_t)buf[1] << 8)
+         | ((uint32_t)buf[2] << 16)
+         | ((uint32_t)buf[3] << 24);
+}
+
+static void writeU64LE(uint8_t* buf, uint64_t val) {
+    writeU32LE(buf,     (uint32_t)val);
+    writeU32LE(buf + 4, (uint32_t)(val >> 32));
+}
+
+static uint64_t readU64LE(const uint8_t* buf) {
+    return (uint64_t)readU32LE(buf) | ((uint64_t)readU32LE(buf + 4) << 32);
+}
+
 static void writeFloatLE(uint8_t* buf, float val) {
     uint32_t bits; memcpy(&bits, &val, 4);
     buf[0] = bits & 0xFF;
@@ -156,10 +261,14 @@ static float readFloatLE(const uint8_t* buf) {
     return val;
 }
 
-static size_t writeString(uint8_t* buf, const char* str) {
+// [len:u8][bytes], clipped to `maxLen` bytes (and to 255, the most a
+// u8 length can say). Writes at most 1 + min(maxLen, 255) bytes.
+static size_t writeString(uint8_t* buf, const char* str, size_t maxLen = 255) {
     if (!str) { buf[0] = 0; return 1; }
-    uint8_t len = (uint8_t)strlen(str);
-    buf[0] = len;
+    if (maxLen > 255) maxLen = 255;
+    size_t len = 0;
+    while (len < maxLen && str[len]) len++;
+    buf[0] = (uint8_t)len;
     memcpy(buf + 1, str, len);
     return 1 + len;
 }
@@ -172,6 +281,38 @@ static size_t readString(const uint8_t* buf, char* out, size_t outSize) {
     return 1 + len;
 }
 
+// ============================================================
+//  FRAME PEEK — header fields without decoding
+// ============================================================
+
+struct FrameHeader {
+    const uint8_t* wid;     // not terminated, points into the frame
+    uint8_t        widLen;
+    uint8_t        type;
+    uint8_t        event;
+};
+
+// `frame` holds one complete frame of `len` bytes (CRC not checked).
+// False if the body is too short for its own header fields.
+static bool peekFrame(const uint8_t* frame, size_t len, FrameHeader& out) {
+    if (len < 5) return false;
+    const size_t end = len - 1;                 // CRC excluded
+    size_t pos = 4;                             // AA VER LEN(2)
+    uint8_t devCount = frame[pos++];
+    for (uint8_t d = 0; d < devCount; d++) {
+        if (pos >= end) return false;
+        pos += 1 + frame[pos];
+    }
+    if (pos >= end) return false;
+    out.widLen = frame[pos];
+    out.wid    = frame + pos + 1;
+    pos += 1 + out.widLen;
+    if (pos + 2 > end) return false;
+    out.type  = frame[pos];
+    out.event = frame[pos + 1];
+    return true;
+}
+
 // ============================================================
 //  BINARYCODEC
 // ============================================================
@@ -366,6 +507,10 @@ public:
         _widgetId[0] = '\0';
     }
 
+    #if INSTANTIOT_LINK_STATS
+    uint32_t crcErrors = 0;  // frames rejected on CRC mismatch
+    #endif
+
     // ============================================================
     //  ENCODE — payload bytes → complete binary frame
     // ============================================================
@@ -380,45 +525,56 @@ public:
         const uint8_t* payloadBytes = nullptr,
         size_t payloadLen = 0
     ) {
-        uint8_t body[256];
-        size_t b = 0;
+        if (!payloadBytes) payloadLen = 0;
+
+        // The body is assembled in place behind the header: no
+        // intermediate copy, the caller's buffer is the only bound
+        const size_t frameSize = frameOverhead(deviceId, widgetId) + payloadLen;
+        if (frameSize > bufferSize || frameSize - 5 > 0xFFFF) return 0;
+
+        size_t b = 4;
 
         // DEV_COUNT + DEV
         if (deviceId && deviceId[0] != '\0') {
-            body[b++] = 1;
-            b += writeString(body + b, deviceId);
+            buffer[b++] = 1;
+            b += writeString(buffer + b, deviceId);
         } else {
-            body[b++] = 0;
+            buffer[b++] = 0;
         }
 
         // WID_LEN + WID
-        b += writeString(body + b, widgetId);
+        b += writeString(buffer + b, widgetId);
 
         // TYPE + EVENT
-        body[b++] = typeCode;
-        body[b++] = eventCode;
+        buffer[b++] = typeCode;
+        buffer[b++] = eventCode;
 
         // PAYLOAD
-        if (payloadBytes && payloadLen > 0) {
-            if (b + payloadLen > sizeof(body)) return 0;
-            memcpy(body + b, payloadBytes, payloadLen);
+        if (payloadLen > 0) {
+            memcpy(buffer + b, payloadBytes, payloadLen);
             b += payloadLen;
         }
 
-        uint16_t len = (uint16_t)b;
-        uint8_t  crc = crc8(body, b);
-
         // header(4) + body + crc(1)
-        size_t frameSize = 4 + b + 1;
-        if (frameSize > bufferSize) return 0;
+        buffer[0] = 0xAA;
+        buffer[1] = 0x01;
+        writeU16LE(buffer + 2, (uint16_t)(b - 4));
+        buffer[b] = crc8(buffer + 4, b - 4);
+        return b + 1;
+    }
 
-        size_t pos = 0;
-        buffer[pos++] = 0xAA;
-        buffer[pos++] = 0x01;
-        writeU16LE(buffer + pos, len); pos += 2;
-        memcpy(buffer + pos, body, b); pos += b;
-        buffer[pos++] = crc;
-        return pos;
+    /** Frame size without payload: header, ids, TYPE, EVENT, CRC. */
+    static size_t frameOverhead(const char* deviceId, const char* widgetId) {
+        size_t n = 4 + 1 + 1 + 2 + 1;   // header, DEV_COUNT, WID_LEN, TYPE + EVENT, CRC
+        if (deviceId && deviceId[0] != '\0') n += 1 + idLength(deviceId);
+        if (widgetId) n += idLength(widgetId);
+        return n;
+    }
+
+    // Id bytes on the wire: writeString() clamps to 255
+    static size_t idLength(const char* s) {
+        const size_t n = strlen(s);
+        return n < 255 ? n : 255;
     }
 
     // ============================================================
@@ -446,6 +602,8 @@ public:
         // CRC — covers the body (after the fixed 4-byte header)
         if (crc8(buffer + 4, len) != buffer[4 + len]) {
             IIOT_LOG("[BinaryCodec] CRC mismatch");
+            IIOT_STAT(crcErrors++);
+            IIOT_TRACE(TRACE_CRC_ERROR, 0, len);
             return false;
         }
 
@@ -469,6 +627,8 @@ public:
         // PAYLOAD
         size_t payloadLen = (bodyStart + len) - pos;
         outMessage.paramCount = 0;
+        outMessage.payload    = buffer + pos;
+        outMessage.payloadLen = payloadLen;
         if (payloadLen > 0)
             decodePayload(outTypeCode, outEventCode, buffer + pos, payloadLen, outMessage);
 
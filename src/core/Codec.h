@@ -34,6 +34,11 @@ struct DecodedMessage {
     Param   params[8];
     uint8_t paramCount;
 
+    // Raw payload bytes (points into the RX buffer — valid only during
+    // dispatch). Used by service frames that are not decoded to params.
+    const uint8_t* payload;
+    size_t         payloadLen;
+
     // ── Helpers ───────────────────────────────────────────────
 
     const char* getParam(const char* key) const {
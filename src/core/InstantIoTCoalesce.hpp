@@ -0,0 +1,127 @@
+#pragma once
+/**
+ * ============================================================
+ * 🕹️ InstantIoTCoalesce.hpp — RX coalescing of continuous input
+ * ============================================================
+ *
+ * A joystick drag or a slider move arrives as a burst of POSCHANGED /
+ * VALUECHANGING frames; when the loop falls behind, several of them
+ * sit in the RX buffer and only the newest one matters. Before the
+ * first frame of a run is dispatched, the coalescer looks ahead over
+ * the complete frames already buffered and marks every continuous
+ * frame (isContinuousEvent) that has a newer one for the same widget.
+ *
+ * Rules:
+ *   - discrete frames (press, release, drag end, ...) are never
+ *     skipped, and act as a barrier: a position sent before a release
+ *     is still dispatched before it;
+ *   - a newer frame only supersedes if its CRC is good;
+ *   - at most INSTANTIOT_RX_COALESCE_WIDGETS widgets are coalesced at
+ *     the same time, the others are dispatched unchanged.
+ *
+ * Lookahead is bounded (INSTANTIOT_RX_COALESCE_FRAMES) and only reads
+ * headers, so a run of N frames costs one extra header walk each.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "BinaryCodec.hpp"
+
+namespace InstantIoT {
+
+class RxCoalescer {
+public:
+    static const uint8_t MAX_FRAMES = INSTANTIOT_RX_COALESCE_FRAMES;
+    static const uint8_t SLOTS      = INSTANTIOT_RX_COALESCE_WIDGETS;
+    static_assert(MAX_FRAMES % 8 == 0 && MAX_FRAMES <= 248,
+                  "INSTANTIOT_RX_COALESCE_FRAMES must be a multiple of 8, at most 248");
+
+    /** Forgets the current lookahead (start of an extractFrames pass). */
+    void reset() { _planned = 0; _next = 0; }
+
+    /**
+     * Called once for each complete frame at the head of `buf`, in
+     * dispatch order. True if that frame is superseded by a newer one
+     * already in the buffer and must be skipped.
+     */
+    bool superseded(const uint8_t* buf, size_t avail) {
+        if (_next >= _planned) {
+            plan(buf, avail);
+            if (_planned == 0) return false;
+        }
+        const uint8_t i = _next++;
+        return (_drop[i >> 3] >> (i & 7)) & 1;
+    }
+
+private:
+    struct Slot {
+        const uint8_t* wid;
+        uint8_t        widLen;
+        uint8_t        type;
+        uint8_t        last;    // ordinal of the newest frame seen
+        bool           used;
+    };
+
+    uint8_t _drop[MAX_FRAMES / 8];
+    Slot    _slots[SLOTS];
+    uint8_t _planned = 0;       // frames covered by the lookahead
+    uint8_t _next    = 0;       // ordinal of the next frame to dispatch
+
+    // Walks the contiguous complete frames from the head of the buffer
+    void plan(const uint8_t* buf, size_t avail) {
+        memset(_drop, 0, sizeof(_drop));
+        for (uint8_t s = 0; s < SLOTS; s++) _slots[s].used = false;
+        _planned = 0;
+        _next    = 0;
+
+        size_t off = 0;
+        while (_planned < MAX_FRAMES && avail - off >= 5) {
+            const uint8_t* f = buf + off;
+            if (f[0] != 0xAA || f[1] != 0x01) break;
+            const size_t size = 4 + (size_t)readU16LE(f + 2) + 1;
+            if (size > avail - off) break;
+
+            FrameHeader h;
+            if (peekFrame(f, size, h)) {
+                if (!isContinuousEvent(h.type, h.event))      barrier(h);
+                else if (crc8(f + 4, size - 5) == f[size - 1]) note(h, _planned);
+            }
+            _planned++;
+            off += size;
+        }
+    }
+
+    Slot* find(const FrameHeader& h) {
+        for (uint8_t s = 0; s < SLOTS; s++) {
+            Slot& sl = _slots[s];
+            if (sl.used && sl.type == h.type && sl.widLen == h.widLen &&
+                memcmp(sl.wid, h.wid, h.widLen) == 0) return &sl;
+        }
+        return nullptr;
+    }
+
+    void note(const FrameHeader& h, uint8_t ordinal) {
+        Slot* sl = find(h);
+        if (sl) {
+            _drop[sl->last >> 3] |= (uint8_t)(1 << (sl->last & 7));
+            sl->last = ordinal;
+            return;
+        }
+        for (uint8_t s = 0; s < SLOTS; s++) {
+            if (_slots[s].used) continue;
+            _slots[s] = { h.wid, h.widLen, h.type, ordinal, true };
+            return;
+        }
+    }
+
+    // A discrete frame pins everything before it for that widget
+    void barrier(const FrameHeader& h) {
+        Slot* sl = find(h);
+        if (sl) sl->used = false;
+    }
+};
+
+} // namespace InstantIoT
@@ -14,6 +14,43 @@
 #include "MessageSender.h"
 #include "../InstantIoTConfig.h"
 #include "../widgets/WidgetIncludes.hpp"
+#if INSTANTIOT_SESSION_RESUME
+#include "InstantIoTSession.hpp"
+#endif
+#if INSTANTIOT_OFFLINE_QUEUE
+#include "InstantIoTOfflineLog.hpp"
+#endif
+#if INSTANTIOT_PING
+#include "InstantIoTRtt.hpp"
+#endif
+#if INSTANTIOT_LINK_STATS
+#include "InstantIoTLinkStats.hpp"
+#endif
+#if INSTANTIOT_TRACE
+#include "InstantIoTTrace.hpp"
+#endif
+#if INSTANTIOT_RX_COALESCE
+#include "InstantIoTCoalesce.hpp"
+#endif
+#if INSTANTIOT_DEFERRED_DISPATCH
+#include "InstantIoTEventQueue.hpp"
+#endif
+#if INSTANTIOT_NETWORK_TASK
+#include "InstantIoTNetTask.hpp"
+#elif INSTANTIOT_TX_MPSC
+#include "InstantIoTTxQueue.hpp"
+#endif
+#if INSTANTIOT_LOOP_STATS
+#include "InstantIoTLoopStats.hpp"
+#define IIOT_PHASE(p) PhaseTimer _iiotPhase(_loopStats, p)
+#else
+#define IIOT_PHASE(p)
+#endif
+#if INSTANTIOT_IDLE_LIGHT_SLEEP && defined(ESP32)
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_wifi.h>
+#endif
 
 namespace InstantIoT {
 
@@ -27,6 +64,9 @@ public:
     {}
 
     virtual ~InstantIoTCoreBase() {
+        #if INSTANTIOT_NETWORK_TASK
+        if (_netTask) vTaskDelete(_netTask);
+        #endif
         #if INSTANTIOT_WIDGETS_LED
         for (uint8_t i = 0; i < _ledCount; i++) delete _leds[i];
         #endif
@@ -64,15 +104,42 @@ public:
             return false;
         }
         _initialized = true;
+        #if (INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC) && defined(ESP32)
+        _ownerTask = xTaskGetCurrentTaskHandle();   // setup() runs in the loop task
+        #endif
+        #if INSTANTIOT_NETWORK_TASK
+        startNetworkTask();
+        #endif
         IIOT_LOG("[InstantIoT] Ready");
         return true;
     }
 
     virtual void loop() {
         if (!_initialized) return;
-        _transport.poll();
-        readLoop();
-        heartbeatTick();
+        #if INSTANTIOT_NETWORK_TASK
+        // I/O runs in the network task: only deliver its events here
+        if (_netTask) {
+            #if INSTANTIOT_STATE_RESYNC
+            resyncStep();
+            #endif
+            #if INSTANTIOT_CHART_HISTORY && INSTANTIOT_WIDGETS_ADVANCEDCHART
+            chartTick();
+            #endif
+            if (_dispatchBudgetUs) dispatchPending(_dispatchBudgetUs);
+            return;
+        }
+        #endif
+        IIOT_PHASE(PHASE_LOOP);
+        ioStep();
+        #if INSTANTIOT_STATE_RESYNC
+        resyncStep();
+        #endif
+        #if INSTANTIOT_CHART_HISTORY && INSTANTIOT_WIDGETS_ADVANCEDCHART
+        chartTick();
+        #endif
+        #if INSTANTIOT_DEFERRED_DISPATCH
+        if (_dispatchBudgetUs) dispatchPending(_dispatchBudgetUs);
+        #endif
     }
 
     // ════════════════════════════════════════════════════════
@@ -91,15 +158,418 @@ public:
     // The `intervalMs` parameter must **match** the one passed to the
     // transport at handshake — the `InstantIoTWiFiServer` facade
     // handles it automatically.
+    //
+    // Traffic-aware: any frame fully written resets the deadline, so a
+    // heartbeat only goes out after `intervalMs` of silence.
     void setHeartbeat(uint32_t intervalMs) {
         _heartbeatMs = intervalMs;
-        _lastHeartbeatSent = 0;  // force a quick emission after set
+        _lastTxAt    = 0;  // force a quick emission after set
+    }
+
+    // Lets the silence after data traffic stretch to
+    // `intervalMs × pct / 100` before a heartbeat is emitted (an idle
+    // link keeps the plain interval). Capped at
+    // INSTANTIOT_HEARTBEAT_MAX_STRETCH_PCT to stay inside the server's
+    // `heartbeat × 2.5` timeout with margin. Default 100 = no stretch.
+    void setHeartbeatStretch(uint16_t pct) {
+        if (pct < 100) pct = 100;
+        if (pct > INSTANTIOT_HEARTBEAT_MAX_STRETCH_PCT) pct = INSTANTIOT_HEARTBEAT_MAX_STRETCH_PCT;
+        _heartbeatStretchPct = pct;
+    }
+
+    #if INSTANTIOT_SESSION_RESUME
+    // ════════════════════════════════════════════════════════
+    // 🔁 ACKED SESSION (server mode)
+    // ════════════════════════════════════════════════════════
+    //
+    // Every data frame is also pushed into a bounded ring and numbered
+    // implicitly (0, 1, 2… in write order — service frames are not
+    // counted). The server acks periodically with `EV_SESSION_ACK`,
+    // which releases the ring.
+    //
+    // After each handshake the server answers `EV_SESSION_RESUME` with
+    // the number of frames it already holds for this session. The device
+    // then sends `EV_SESSION_REPLAY` (seq of the next frame) and replays
+    // the rest of the ring: no gap, no duplicate. Frames sent between the
+    // connection edge and the RESUME stay in the ring so that ordering is
+    // preserved.
+    //
+    // `sessionId` must be announced in the handshake — the
+    // `InstantIoTWiFiServer` facade handles it. `0` disables.
+    void enableAckedSession(uint32_t sessionId) {
+        _sessionId     = sessionId;
+        _resumePending = false;
+        _sessionRing.clear(0);
+    }
+
+    uint32_t sessionId()     const { return _sessionId; }
+    uint32_t unackedFrames() const { return _sessionRing.count(); }
+    uint32_t evictedFrames() const { return _sessionRing.evicted(); }
+    #endif
+
+    #if INSTANTIOT_OFFLINE_QUEUE
+    // ════════════════════════════════════════════════════════
+    // 💾 OFFLINE QUEUE (store-and-forward)
+    // ════════════════════════════════════════════════════════
+    //
+    // While the transport is down, data frames are appended to a
+    // flash log instead of being dropped (`sendBinary` returns true).
+    // Once connected again, the log is drained at
+    // INSTANTIOT_OFFLINE_DRAIN_BATCH frames every
+    // INSTANTIOT_OFFLINE_DRAIN_INTERVAL_MS; until it is empty, new frames
+    // queue behind it so the server receives them in order.
+    //
+    // Usage (ESP32):
+    //   LittleFS.begin(true);
+    //   static InstantIoT::FileOfflineStorage storage("/littlefs/iiotq");
+    //   instant.enableOfflineQueue(storage);
+    bool enableOfflineQueue(IOfflineStorage& storage) {
+        return _offline.begin(storage);
+    }
+
+    uint32_t offlinePending() const { return _offline.pending(); }
+    uint32_t offlineDropped() const { return _offline.dropped(); }
+    #endif
+
+    #if INSTANTIOT_TIME_SYNC
+    // ════════════════════════════════════════════════════════
+    // ⏲️ TIME SYNC (server mode)
+    // ════════════════════════════════════════════════════════
+    //
+    // Sends a `TYPE_TIMESYNC` request at each connection and then
+    // every `intervalMs`. The server answers with its receive (t2) and
+    // send (t3) timestamps; with the local send (t1) and receive (t4)
+    // times the device estimates, as NTP does:
+    //
+    //   offset = ((t2 − t1) + (t3 − t4)) / 2
+    //   rtt    = (t4 − t1) − (t3 − t2)
+    //
+    // The lowest-RTT sample among the last INSTANTIOT_TIMESYNC_SAMPLES
+    // is kept (least queuing delay → least asymmetry error).
+    //
+    // `intervalMs = 0` disables.
+    void setTimeSync(uint32_t intervalMs) {
+        _timeSyncMs   = intervalMs;
+        _syncRequest  = true;
+    }
+
+    bool     timeSynced()  const { return _syncCount > 0; }
+    uint32_t clockRttMs()  const { return timeSynced() ? _sync[_syncBest].rtt : 0; }
+
+    uint64_t serverTimeMs(uint32_t localMs) override {
+        if (!timeSynced()) return 0;
+        const SyncSample& b = _sync[_syncBest];
+        return b.server + (int64_t)(int32_t)(localMs - b.local);
+    }
+    #endif
+
+    #if INSTANTIOT_PING
+    // ════════════════════════════════════════════════════════
+    // 🏓 LATENCY PROBE
+    // ════════════════════════════════════════════════════════
+    //
+    // Sends a `TYPE_PING` frame every `intervalMs` and measures the
+    // round trip when the matching PONG comes back (µs, from micros()).
+    // Pings received from the peer are answered automatically. A ping
+    // still unanswered when the next one is due counts as lost.
+    //
+    // Statistics cover the current connection only (reset on connect).
+    // `intervalMs = 0` disables emission (incoming pings are still
+    // answered).
+    void setPingInterval(uint32_t intervalMs) {
+        _pingMs = intervalMs;
+    }
+
+    RttStats rttStats() const { return _rtt.snapshot(); }
+    #endif
+
+    #if INSTANTIOT_LINK_STATS
+    // ════════════════════════════════════════════════════════
+    // 📊 LINK STATS
+    // ════════════════════════════════════════════════════════
+    //
+    // Snapshot of the core counters merged with the codec CRC count
+    // and the transport's reconnect counters (see LinkStats).
+    LinkStats linkStats() const {
+        LinkStats s = _linkStats;
+        s.crcErrors         = _codec.crcErrors;
+        s.reconnectAttempts = _transport.stats.reconnectAttempts;
+        s.reconnectFailures = _transport.stats.reconnectFailures;
+        #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+        s.txQueueDrops = _txQueueDrops;
+        #endif
+        return s;
+    }
+
+    void resetLinkStats() {
+        _linkStats.reset();
+        _codec.crcErrors = 0;
+        _transport.stats = TransportStats();
+        #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+        _txQueueDrops = 0;
+        #endif
+    }
+
+    // Sends the snapshot as a `TYPE_STATS` frame every `intervalMs`
+    // while connected. `intervalMs = 0` disables (default).
+    void setStatsReport(uint32_t intervalMs) {
+        _statsMs     = intervalMs;
+        _lastStatsAt = millis();
+    }
+    #endif
+
+    #if INSTANTIOT_DEFERRED_DISPATCH
+    // ════════════════════════════════════════════════════════
+    // 📬 DEFERRED DISPATCH
+    // ════════════════════════════════════════════════════════
+    //
+    // Widget frames are decoded into a bounded queue while parsing;
+    // the handlers run afterwards, from dispatchPending(). A slow
+    // handler then delays only the next handlers, not the RX drain.
+    // When the queue is full, parsing stops and the frames wait in the
+    // RX buffer, then in the transport (TCP window): backpressure
+    // instead of loss. Service frames are still handled inline.
+
+    /**
+     * Handler time granted per loop() (µs). At least one event runs per
+     * call even if it alone exceeds the budget. `0`: loop() does not
+     * dispatch at all — call dispatchPending() yourself, e.g. from a
+     * task on the other core (one consumer only).
+     */
+    void setDispatchBudget(uint32_t us) { _dispatchBudgetUs = us; }
+
+    /**
+     * Delivers queued events, oldest first, until the queue is empty
+     * or `budgetUs` has elapsed.
+     * @return events delivered
+     */
+    size_t dispatchPending(uint32_t budgetUs = UINT32_MAX) {
+        const uint32_t t0 = micros();
+        size_t n = 0;
+        while (QueuedEvent* q = _events.front()) {
+            IIOT_TRACE(TRACE_DISPATCH, q->typeCode, q->eventCode);
+            #if INSTANTIOT_TRACE || INSTANTIOT_LOOP_STATS
+            const uint32_t t = micros();
+            #endif
+            WidgetRegistry::deliver(q->get());
+            const uint32_t now = micros();
+            #if INSTANTIOT_TRACE || INSTANTIOT_LOOP_STATS
+            const uint32_t took = now - t;
+            IIOT_TRACE(TRACE_DISPATCH_END, q->typeCode, took > 0xFFFF ? 0xFFFF : took);
+            #endif
+            #if INSTANTIOT_LOOP_STATS
+            _loopStats.addDispatch(q->typeCode, took);
+            #endif
+            _events.pop();
+            n++;
+            if (now - t0 >= budgetUs) break;
+        }
+        return n;
+    }
+
+    size_t pendingEvents() const { return _events.size(); }
+    #endif
+
+    #if INSTANTIOT_TRACE
+    // ════════════════════════════════════════════════════════
+    // 🧵 TRACE
+    // ════════════════════════════════════════════════════════
+    //
+    // The binary trace ring (see InstantIoTTrace.hpp) dumped on
+    // demand, oldest record first; recording is paused meanwhile.
+    // Decode with `python3 extras/iiot_trace.py <capture>`.
+
+    // Stream format, e.g. `instant.dumpTrace(Serial)`
+    void dumpTrace(Print& out) { traceRing().dump(out); }
+
+    // TYPE_TRACE frames over the active transport
+    bool sendTrace() {
+        if (!_transport.connected()) return false;
+        static const uint16_t PER_CHUNK = 24;   // 4 + 24 × 8 = 196 B payload
+        TraceRing& ring = traceRing();
+        ring.pause(true);
+        const uint16_t n      = ring.count();
+        const uint16_t chunks = n ? (uint16_t)((n + PER_CHUNK - 1) / PER_CHUNK) : 1;
+        bool ok = true;
+        for (uint16_t c = 0; c < chunks && ok; c++) {
+            uint8_t p[4 + PER_CHUNK * TraceRing::RECORD_SIZE];
+            writeU16LE(p, c);
+            writeU16LE(p + 2, chunks);
+            size_t len = 4;
+            for (uint16_t i = c * PER_CHUNK; i < n && i < (c + 1) * PER_CHUNK; i++) {
+                ring.read(i, p + len);
+                len += TraceRing::RECORD_SIZE;
+            }
+            ok = sendBinary("", TYPE_TRACE, EV_TRACE_CHUNK, p, len);
+        }
+        ring.pause(false);
+        return ok;
+    }
+
+    void clearTrace() { traceRing().clear(); }
+    #endif
+
+    #if INSTANTIOT_LOOP_STATS
+    // ════════════════════════════════════════════════════════
+    // ⏲️ LOOP STATS
+    // ════════════════════════════════════════════════════════
+    //
+    // Latency histograms of each loop() phase (see LoopPhase), from
+    // micros(). Read them in code, or push a summary to a widget:
+    //
+    //   instant.publishLoopStats(instant.text("diag"));    // p50/p99/max
+    //   instant.publishLoopStats(instant.barChart("diag")); // p99 per phase
+    const LoopStats& loopStats() const { return _loopStats; }
+    void resetLoopStats() { _loopStats.reset(); }
+
+    #if INSTANTIOT_WIDGETS_TEXT
+    void publishLoopStats(TextWidget& w) {
+        char txt[128];
+        _loopStats.format(txt, sizeof(txt));
+        w.setText(txt);
+    }
+    #endif
+
+    #if INSTANTIOT_WIDGETS_BARCHART
+    // One bar per LoopPhase, in enum order, value = percentile in µs
+    void publishLoopStats(BarChartWidget& w, uint8_t pct = 99) {
+        float v[PHASE_COUNT];
+        for (uint8_t i = 0; i < PHASE_COUNT; i++)
+            v[i] = (float)_loopStats.phase((LoopPhase)i).percentileUs(pct);
+        w.setValues(v, PHASE_COUNT);
+    }
+    #endif
+    #endif
+
+    // ════════════════════════════════════════════════════════
+    // 💤 IDLE
+    // ════════════════════════════════════════════════════════
+    //
+    // How long `loop()` may be skipped without missing anything the
+    // core schedules itself (heartbeat, ping, time sync, offline
+    // queue, session resume timeout, transport reconnect backoff).
+    // `appDueMs` folds in the sketch's own deadline, typically
+    // `timers.nextDueInMs()`. 0 = work pending, call `loop()` now.
+    uint32_t idleBudgetMs(uint32_t appDueMs = UINT32_MAX) {
+        if (!_initialized) return 0;
+        #if INSTANTIOT_CHART_HISTORY && INSTANTIOT_WIDGETS_ADVANCEDCHART
+        appDueMs = minDue(appDueMs, chartDueMs());   // reducer buckets to close
+        #endif
+        #if INSTANTIOT_NETWORK_TASK
+        // Sketch side: only the queued events are the sketch's business
+        if (_netTask && !inNetworkTask()) {
+            #if INSTANTIOT_STATE_RESYNC
+            if (resyncPending()) return 0;
+            #endif
+            return (_dispatchBudgetUs && !_events.empty()) ? 0 : appDueMs;
+        }
+        #endif
+        #if INSTANTIOT_STATE_RESYNC
+        if (!netTaskRunning() && resyncPending()) return 0;
+        #endif
+        if (_transport.available() > 0) return 0;
+        #if INSTANTIOT_DEFERRED_DISPATCH
+        if (_dispatchBudgetUs && !_events.empty() && !netTaskRunning()) return 0;
+        #endif
+        #if INSTANTIOT_TX_MPSC
+        if (!netTaskRunning() && !_txQueue.empty()) return 0;
+        #endif
+
+        const uint32_t now = millis();
+        uint32_t budget = appDueMs;
+        budget = minDue(budget, _transport.pollDueInMs());
+        if (!_transport.connected()) {
+            #if INSTANTIOT_OFFLINE_QUEUE
+            if (_offline.attached()) budget = minDue(budget, _offline.flushDueInMs());
+            #endif
+            return budget;
+        }
+
+        if (_heartbeatMs) budget = minDue(budget, dueIn(_lastTxAt + heartbeatDeadlineMs(), now));
+        #if INSTANTIOT_SESSION_RESUME
+        if (_resumePending) budget = minDue(budget, dueIn(_resumeDeadline, now));
+        #endif
+        #if INSTANTIOT_OFFLINE_QUEUE
+        if (_offline.attached()) {
+            budget = minDue(budget, _offline.flushDueInMs());
+            if (!_offline.empty()) budget = minDue(budget, dueIn(_lastDrainAt + INSTANTIOT_OFFLINE_DRAIN_INTERVAL_MS, now));
+        }
+        #endif
+        #if INSTANTIOT_TIME_SYNC
+        if (_timeSyncMs) budget = minDue(budget, _syncRequest ? 0 : dueIn(_syncSentAt + _timeSyncMs, now));
+        #endif
+        #if INSTANTIOT_PING
+        if (_pingMs) budget = minDue(budget, dueIn(_lastPingAt + _pingMs, now));
+        #endif
+        #if INSTANTIOT_LINK_STATS
+        if (_statsMs) budget = minDue(budget, dueIn(_lastStatsAt + _statsMs, now));
+        #endif
+        return budget;
+    }
+
+    // Sleeps for `idleBudgetMs(appDueMs)`, capped at
+    // INSTANTIOT_IDLE_MAX_MS. Transports that support it (TCP on
+    // ESP32) return as soon as data arrives, so incoming commands
+    // keep their latency; the others fall back to `delay()`.
+    // Call at the end of `loop()`:
+    //
+    //   instant.loop();
+    //   timers.run();
+    //   instant.idle(timers.nextDueInMs());
+    void idle(uint32_t appDueMs = UINT32_MAX) {
+        uint32_t ms = idleBudgetMs(appDueMs);
+        if (ms > INSTANTIOT_IDLE_MAX_MS) ms = INSTANTIOT_IDLE_MAX_MS;
+        if (ms == 0) return;
+        #if INSTANTIOT_NETWORK_TASK
+        // The transport belongs to the network task, which wakes us
+        // up when it queues an event
+        if (_netTask) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+            return;
+        }
+        #endif
+        if (_transport.waitForData(ms) < 0) delay(ms);
+    }
+
+    #if INSTANTIOT_IDLE_LIGHT_SLEEP && defined(ESP32)
+    // Lets the ESP32 enter light sleep whenever every task is blocked
+    // (e.g. inside `idle()`), WiFi staying associated in modem-sleep.
+    // Needs power management in the SDK build (CONFIG_PM_ENABLE);
+    // returns false when it is not available.
+    bool enableLightSleep(uint16_t maxMhz = 240, uint16_t minMhz = 40) {
+        #if ESP_IDF_VERSION_MAJOR >= 5
+        esp_pm_config_t cfg = {};
+        #elif CONFIG_IDF_TARGET_ESP32S3
+        esp_pm_config_esp32s3_t cfg = {};
+        #elif CONFIG_IDF_TARGET_ESP32S2
+        esp_pm_config_esp32s2_t cfg = {};
+        #elif CONFIG_IDF_TARGET_ESP32C3
+        esp_pm_config_esp32c3_t cfg = {};
+        #else
+        esp_pm_config_esp32_t cfg = {};
+        #endif
+        cfg.max_freq_mhz       = maxMhz;
+        cfg.min_freq_mhz       = minMhz;
+        cfg.light_sleep_enable = true;
+        esp_err_t err = esp_pm_configure(&cfg);
+        if (err != ESP_OK) {
+            IIOT_LOG_VAL("[Core] Light sleep unavailable, err=", (long)err);
+            return false;
+        }
+        esp_wifi_set_ps(WIFI_PS_MIN_MODEM);  // no-op error if WiFi is off
+        return true;
     }
+    #endif
 
     bool connected() override {
         return _transport.connected();
     }
 
+    size_t maxPayloadLen(const char* widgetId) override {
+        const size_t over = BinaryCodec::frameOverhead(_config.getDeviceId(), widgetId);
+        return over < sizeof(_txBuffer) ? sizeof(_txBuffer) - over : 0;
+    }
+
     bool sendBinary(
         const char* widgetId,
         uint8_t typeCode,
@@ -107,7 +577,19 @@ public:
         const uint8_t* payloadBytes = nullptr,
         size_t payloadLen = 0
     ) override {
-        if (!_transport.connected()) return false;
+        #if INSTANTIOT_BATCH
+        if (_batchDepth && !isServiceType(typeCode) && inBatchContext())
+            return batchAppend(widgetId, typeCode, eventCode, payloadBytes, payloadLen);
+        #endif
+        #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+        // Another task / an ISR: hand the frame to the I/O context
+        if (!onIoContext())
+            return queueTx(widgetId, typeCode, eventCode, payloadBytes, payloadLen);
+        #endif
+        checkConnection();
+        bool online = _transport.connected();
+        bool queue  = shouldQueueOffline(typeCode, online);
+        if (!online && !queue) { IIOT_STAT(_linkStats.txDropped++); return false; }
 
         size_t len = _codec.encode(
             _txBuffer, sizeof(_txBuffer),
@@ -119,8 +601,11 @@ public:
             payloadLen
         );
 
-        if (len == 0) return false;
-        return _transport.write(_txBuffer, len) == len;
+        if (len == 0) { IIOT_STAT(_linkStats.txDropped++); return false; }
+        #if INSTANTIOT_OFFLINE_QUEUE
+        if (queue) return _offline.append(_txBuffer, (uint16_t)len);
+        #endif
+        return emitFrame(_txBuffer, len, isDataType(typeCode));
     }
 
     // ════════════════════════════════════════════════════════
@@ -231,6 +716,60 @@ public:
     }
     #endif
 
+    #if INSTANTIOT_STATE_RESYNC
+    // ════════════════════════════════════════════════════════
+    // 🔄 STATE RESYNC
+    // ════════════════════════════════════════════════════════
+    //
+    // Every display widget keeps the last state the sketch set; after
+    // each connect edge the core re-sends all of it from loop(), once
+    // the session replay and the offline queue are done (they carry
+    // older values). Call resync() to do it on demand.
+    void resync() { requestResync(); }
+    #endif
+
+    #if INSTANTIOT_BATCH
+    // ════════════════════════════════════════════════════════
+    // 📦 BATCHED UPDATES
+    // ════════════════════════════════════════════════════════
+    //
+    // Widget sends between beginUpdate() and commit() are buffered and
+    // leave as one TYPE_BATCH frame, applied by the app at once:
+    //
+    //   instant.beginUpdate();
+    //   instant.led("run").setColor(0, 255, 0);
+    //   instant.gauge("rpm").setValue(rpm);
+    //   instant.text("state").setText("RUNNING");
+    //   instant.commit();
+    //
+    // Scopes nest; the outermost commit() sends. A full buffer is sent
+    // early (the scene then arrives in several batches, in order); a
+    // batch holding a single send goes out as that plain frame. Only
+    // the task that called beginUpdate() is captured: other tasks and
+    // ISRs keep sending directly.
+    void beginUpdate() {
+        if (_batchDepth++ == 0) {
+            _batchLen   = 1;
+            _batchCount = 0;
+            #if defined(ESP32) && (INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC)
+            _batchTask  = xTaskGetCurrentTaskHandle();
+            #endif
+        }
+    }
+
+    /**
+     * Closes the scope opened by beginUpdate().
+     * @return false if the batch could not be sent (or no scope was open)
+     */
+    bool commit() {
+        if (_batchDepth == 0) return false;
+        if (--_batchDepth) return true;
+        return flushBatch();
+    }
+
+    bool updating() const { return _batchDepth != 0; }
+    #endif
+
     // ════════════════════════════════════════════════════════
     // ⚙️ CONFIG
     // ════════════════════════════════════════════════════════
@@ -247,26 +786,661 @@ protected:
     uint8_t _txBuffer[INSTANT_TX_BUFFER_SIZE];
 
     bool _initialized;
+    bool _wasConnected = false;
+
+    #if INSTANTIOT_SESSION_RESUME
+    // ─── Acked session state (server mode) ────────────────
+    FrameRing<INSTANTIOT_SESSION_RING_SIZE> _sessionRing;
+    uint32_t _sessionId      = 0;      // 0 = acked mode disabled
+    bool     _resumePending  = false;  // waiting for EV_SESSION_RESUME
+    uint32_t _resumeDeadline = 0;
+    uint32_t _edgeSeq        = 0;      // first seq pushed since the last connect
+    #endif
+
+    #if INSTANTIOT_TIME_SYNC
+    // ─── Time sync state ──────────────────────────────────
+    struct SyncSample {
+        uint32_t local;    // device millis() at t4
+        uint64_t server;   // estimated server time at `local`
+        uint32_t rtt;
+    };
+    SyncSample _sync[INSTANTIOT_TIMESYNC_SAMPLES];
+    uint8_t  _syncCount   = 0;
+    uint8_t  _syncNext    = 0;
+    uint8_t  _syncBest    = 0;
+    uint32_t _timeSyncMs  = 0;     // 0 = disabled
+    uint32_t _syncSentAt  = 0;     // t1 of the outstanding request
+    bool     _syncRequest = false; // request due as soon as connected
+    #endif
+
+    #if INSTANTIOT_PING
+    // ─── Latency probe state ──────────────────────────────
+    RttWindow _rtt;
+    uint32_t  _pingMs      = 0;      // 0 = no emission
+    uint32_t  _lastPingAt  = 0;
+    uint16_t  _pingId      = 0;
+    bool      _pingPending = false;  // waiting for the PONG of _pingId
+    #endif
+
+    #if INSTANTIOT_OFFLINE_QUEUE
+    // ─── Offline queue state ──────────────────────────────
+    OfflineLog _offline;
+    uint32_t   _lastDrainAt = 0;
+    #endif
+
+    #if INSTANTIOT_BATCH
+    // ─── Batched update state ─────────────────────────────
+    uint8_t  _batchBuf[INSTANTIOT_BATCH_BUFFER_SIZE];   // [count] + records
+    size_t   _batchLen   = 1;
+    uint8_t  _batchCount = 0;
+    uint8_t  _batchDepth = 0;     // nested beginUpdate() scopes
+    #if defined(ESP32) && (INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC)
+    TaskHandle_t _batchTask = nullptr;
+    #endif
+    #endif
+
+    #if INSTANTIOT_LINK_STATS
+    // ─── Link stats state ─────────────────────────────────
+    LinkStats _linkStats = {};
+    uint32_t  _statsMs     = 0;  // 0 = no periodic report
+    uint32_t  _lastStatsAt = 0;
+
+    void statsTick() {
+        if (_statsMs == 0 || !_transport.connected()) return;
+        uint32_t now = millis();
+        if (now - _lastStatsAt < _statsMs) return;
+        _lastStatsAt = now;
+        uint8_t p[2 + LinkStats::FIELD_COUNT * 4];
+        size_t n = linkStats().encode(p);
+        sendBinary("", TYPE_STATS, EV_STATS_REPORT, p, n);
+    }
+    #endif
+
+    #if INSTANTIOT_TRACE
+    uint16_t _resyncRun = 0;  // bytes skipped since the last frame
+    #endif
+
+    #if INSTANTIOT_RX_COALESCE
+    RxCoalescer _coalescer;
+    #endif
+
+    #if INSTANTIOT_DEFERRED_DISPATCH
+    EventQueue _events;
+    uint32_t   _dispatchBudgetUs = INSTANTIOT_DISPATCH_BUDGET_US;
+    #endif
+
+    #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+    TxQueue           _txQueue;
+    volatile uint32_t _txQueueDrops = 0;    // queue full / frame too large
+    #endif
+
+    #if (INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC) && defined(ESP32)
+    TaskHandle_t _ownerTask = nullptr;      // task that called begin() (the loop task)
+    #endif
+
+    #if INSTANTIOT_NETWORK_TASK
+    TaskHandle_t _netTask = nullptr;
+    #endif
+
+    #if INSTANTIOT_LOOP_STATS
+    // ─── Loop stats state ─────────────────────────────────
+    LoopStats _loopStats;
+    uint32_t  _frameUs = 0;  // decode + dispatch time of the current extractFrames()
+    #endif
 
     // ─── Heartbeat state (server mode) ────────────────────
-    uint32_t _heartbeatMs       = 0;   // 0 = disabled
-    uint32_t _lastHeartbeatSent = 0;
+    uint32_t _heartbeatMs         = 0;     // 0 = disabled
+    uint16_t _heartbeatStretchPct = 100;
+    uint32_t _lastTxAt            = 0;     // last frame fully written
+    bool     _lastTxWasData       = false; // false after a heartbeat
 
     /**
      * To be called in `loop()`: sends a `TYPE_HEARTBEAT` frame
-     * if the configured interval has elapsed. No-op if `_heartbeatMs == 0`
-     * or if the transport is not connected.
+     * if nothing was written for the heartbeat interval. No-op if
+     * `_heartbeatMs == 0` or if the transport is not connected.
      */
     void heartbeatTick() {
         if (_heartbeatMs == 0) return;
         if (!_transport.connected()) return;
-        uint32_t now = millis();
-        if (now - _lastHeartbeatSent < _heartbeatMs) return;
-        _lastHeartbeatSent = now;
+        if (millis() - _lastTxAt < heartbeatDeadlineMs()) return;
+        _lastTxAt = millis();      // the attempt: a failed write is not retried at once
         // Empty WID + TYPE_HEARTBEAT + EVENT 0 + no payload
         sendBinary("", TYPE_HEARTBEAT, 0);
+        _lastTxWasData = false;
+    }
+
+    static uint32_t dueIn(uint32_t dueAt, uint32_t now) {
+        int32_t d = (int32_t)(dueAt - now);
+        return d > 0 ? (uint32_t)d : 0;
+    }
+
+    static uint32_t minDue(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+    /** Allowed silence before the next heartbeat. */
+    uint32_t heartbeatDeadlineMs() const {
+        if (!_lastTxWasData || _heartbeatStretchPct == 100) return _heartbeatMs;
+        return (uint32_t)(((uint64_t)_heartbeatMs * _heartbeatStretchPct) / 100);
+    }
+
+    // ════════════════════════════════════════════════════════
+    // 📤 TX — single exit point for encoded frames
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @param isData false for service frames (never queued nor counted)
+     * @return true once the frame is written — or owned by the acked
+     *         session ring, which will replay it if the write fails
+     */
+    bool emitFrame(const uint8_t* frame, size_t len, bool isData) {
+        #if INSTANTIOT_SESSION_RESUME
+        uint32_t seq;
+        if (_sessionId && isData && _sessionRing.push(frame, (uint16_t)len, seq)) {
+            if (!_resumePending && writeFrame(frame, len)) _lastTxWasData = true;
+            return true;
+        }
+        #endif
+        if (!writeFrame(frame, len)) return false;
+        if (isData) _lastTxWasData = true;
+        return true;
+    }
+
+    bool writeFrame(const uint8_t* frame, size_t len) {
+        size_t written;
+        {
+            IIOT_PHASE(PHASE_TX_WRITE);
+            written = _transport.write(frame, len);
+        }
+        IIOT_STAT(_linkStats.bytesOut += (uint32_t)written);
+        if (written != len) {
+            IIOT_STAT(_linkStats.shortWrites++);
+            IIOT_TRACE(TRACE_TX_SHORT, frameType(frame, len), written);
+            return false;
+        }
+        IIOT_STAT(_linkStats.framesOut++);
+        IIOT_TRACE(TRACE_TX_FRAME, frameType(frame, len), len);
+        _lastTxAt = millis();
+        return true;
+    }
+
+    /** TYPE byte of an encoded frame (0 if malformed). */
+    static uint8_t frameType(const uint8_t* f, size_t len) {
+        FrameHeader h;
+        return peekFrame(f, len, h) ? h.type : 0;
+    }
+
+    /** True if a frame of this type must go to the offline log. */
+    bool shouldQueueOffline(uint8_t typeCode, bool online) {
+        #if INSTANTIOT_OFFLINE_QUEUE
+        if (!_offline.attached() || !isDataType(typeCode)) return false;
+        return !online || !_offline.empty();
+        #else
+        (void)typeCode; (void)online;
+        return false;
+        #endif
+    }
+
+    #if INSTANTIOT_OFFLINE_QUEUE
+    void offlineTick() {
+        if (!_offline.attached()) return;
+        _offline.tick();
+        if (_offline.empty() || !_transport.connected()) return;
+
+        uint32_t now = millis();
+        if (now - _lastDrainAt < INSTANTIOT_OFFLINE_DRAIN_INTERVAL_MS) return;
+        _lastDrainAt = now;
+
+        for (uint8_t i = 0; i < INSTANTIOT_OFFLINE_DRAIN_BATCH; i++) {
+            size_t len = _offline.peek(_txBuffer, sizeof(_txBuffer));
+            if (len == 0) break;
+            if (!emitFrame(_txBuffer, len, true)) break;  // retried next tick
+            _offline.pop();
+        }
+    }
+    #endif
+
+    #if INSTANTIOT_TIME_SYNC
+    void timeSyncTick() {
+        if (_timeSyncMs == 0 || !_transport.connected()) return;
+        uint32_t now = millis();
+        if (!_syncRequest && now - _syncSentAt < _timeSyncMs) return;
+        _syncRequest = false;
+        _syncSentAt  = now;
+        uint8_t p[4];
+        writeU32LE(p, now);
+        sendBinary("", TYPE_TIMESYNC, EV_TIMESYNC_REQ, p, 4);
+    }
+
+    void handleTimeSyncFrame(uint8_t eventCode, const DecodedMessage& msg) {
+        if (eventCode != EV_TIMESYNC_RESP || msg.payloadLen < 20) return;
+        uint32_t t4 = millis();
+        uint32_t t1 = readU32LE(msg.payload);
+        if (t1 != _syncSentAt) return;  // stale answer
+        int64_t t2 = (int64_t)readU64LE(msg.payload + 4);
+        int64_t t3 = (int64_t)readU64LE(msg.payload + 12);
+
+        int64_t elapsed = (int64_t)(uint32_t)(t4 - t1);
+        int64_t rtt     = elapsed - (t3 - t2);
+        if (rtt < 0) rtt = 0;
+        // offset expressed as "server time at t4"
+        int64_t offset  = ((t2 - (int64_t)t1) + (t3 - ((int64_t)t1 + elapsed))) / 2;
+
+        SyncSample& s = _sync[_syncNext];
+        s.local  = t4;
+        s.server = (uint64_t)((int64_t)t1 + elapsed + offset);
+        s.rtt    = (uint32_t)rtt;
+        _syncNext = (_syncNext + 1) % INSTANTIOT_TIMESYNC_SAMPLES;
+        if (_syncCount < INSTANTIOT_TIMESYNC_SAMPLES) _syncCount++;
+
+        _syncBest = 0;
+        for (uint8_t i = 1; i < _syncCount; i++)
+            if (_sync[i].rtt < _sync[_syncBest].rtt) _syncBest = i;
+        IIOT_LOG_2("[Core] Time sync rtt=", (long)rtt, " best=", (long)_sync[_syncBest].rtt);
+    }
+    #endif
+
+    #if INSTANTIOT_PING
+    void pingTick() {
+        if (_pingMs == 0 || !_transport.connected()) return;
+        uint32_t now = millis();
+        if (now - _lastPingAt < _pingMs) return;
+        _lastPingAt = now;
+        if (_pingPending) _rtt.countLost();
+
+        uint8_t p[6];
+        writeU16LE(p, ++_pingId);
+        writeU32LE(p + 2, micros());
+        _pingPending = sendBinary("", TYPE_PING, EV_PING, p, 6);
+        if (_pingPending) _rtt.countSent();
+    }
+
+    void handlePingFrame(uint8_t eventCode, const DecodedMessage& msg) {
+        if (eventCode == EV_PING) {
+            sendBinary("", TYPE_PING, EV_PONG, msg.payload, msg.payloadLen);
+            return;
+        }
+        if (eventCode != EV_PONG || msg.payloadLen < 6 || !_pingPending) return;
+        if (readU16LE(msg.payload) != _pingId) return;  // late answer, already counted lost
+        _pingPending = false;
+        _rtt.add(micros() - readU32LE(msg.payload + 2));
+    }
+    #endif
+
+    // ════════════════════════════════════════════════════════
+    // 🔌 CONNECTION EDGES
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * Detects connect / disconnect edges of the transport. Called from
+     * `loop()` and before each send, so that the first frame after a
+     * reconnect already sees the new state.
+     */
+    void checkConnection() {
+        bool now = _transport.connected();
+        if (now == _wasConnected) return;
+        _wasConnected = now;
+        onConnectionChanged(now);
+    }
+
+    void onConnectionChanged(bool isConnected) {
+        IIOT_LOG_VAL("[Core] Connected: ", isConnected ? "yes" : "no");
+        IIOT_STAT(isConnected ? _linkStats.connects++ : _linkStats.disconnects++);
+        IIOT_TRACE(isConnected ? TRACE_CONNECT : TRACE_DISCONNECT, 0, 0);
+        #if INSTANTIOT_PING
+        if (_pingPending && !isConnected) _rtt.countLost();
+        _pingPending = false;
+        if (isConnected) _rtt.reset();
+        #endif
+        if (!isConnected) {
+            #if INSTANTIOT_STATE_RESYNC
+            _resyncArmed = false;
+            #endif
+            return;
+        }
+        #if INSTANTIOT_SESSION_RESUME
+        if (_sessionId) {
+            _resumePending  = true;
+            _resumeDeadline = millis() + INSTANTIOT_SESSION_RESUME_TIMEOUT_MS;
+            _edgeSeq        = _sessionRing.nextSeq();
+        }
+        #endif
+        #if INSTANTIOT_TIME_SYNC
+        _syncRequest = true;
+        #endif
+        #if INSTANTIOT_STATE_RESYNC
+        _resyncArmed = true;
+        #endif
+        #if INSTANTIOT_WIDGETS_LED
+        // A new peer runs no animation: the next animate() must go out
+        for (uint8_t i = 0; i < _ledCount; i++) _leds[i]->invalidateAnimation();
+        #endif
+        #if INSTANTIOT_WIDGETS_TEXT
+        // ...nor any text: unchanged text must go out again
+        for (uint8_t i = 0; i < _textCount; i++) _texts[i]->invalidateText();
+        #endif
+        #if INSTANTIOT_WIDGETS_BARCHART && INSTANTIOT_BAR_DELTA
+        // A new peer has no bars to apply deltas to
+        for (uint8_t i = 0; i < _barChartCount; i++) _barCharts[i]->invalidateDelta();
+        #endif
+        #if INSTANTIOT_WIDGETS_ADVANCEDCHART
+        // The peer may have lost the time base of timestamped points
+        for (uint8_t i = 0; i < _chartCount; i++) _charts[i]->invalidateTimeBase();
+        #endif
+    }
+
+    #if INSTANTIOT_SESSION_RESUME
+    /**
+     * Fallback when the server never answers `EV_SESSION_RESUME`
+     * (server without acked-session support): only the frames held
+     * since the connection edge are written, the older ones are
+     * considered lost as in non-acked mode.
+     */
+    void sessionTick() {
+        if (!_resumePending || !_transport.connected()) return;
+        if ((int32_t)(millis() - _resumeDeadline) < 0) return;
+        IIOT_LOG("[Core] No session resume from server — plain mode");
+        _resumePending = false;
+        replayFrom(_edgeSeq);
+    }
+
+    void handleSessionFrame(uint8_t eventCode, const DecodedMessage& msg) {
+        if (!_sessionId || msg.payloadLen < 4) return;
+        uint32_t count = readU32LE(msg.payload);
+
+        if (eventCode == EV_SESSION_ACK) {
+            _sessionRing.ackUpTo(count);
+            return;
+        }
+
+        if (eventCode == EV_SESSION_RESUME) {
+            // Duplicate, or late after sessionTick() gave up: already replayed
+            if (!_resumePending) return;
+
+            // Server ahead of us: stale session, nothing to replay
+            if ((int32_t)(count - _sessionRing.nextSeq()) > 0) count = _sessionRing.nextSeq();
+            _sessionRing.ackUpTo(count);
+
+            // oldestSeq() > count when frames were evicted: the server
+            // realigns its counter on the REPLAY seq (known gap)
+            uint32_t from = _sessionRing.oldestSeq();
+            IIOT_LOG_2("[Core] Session resume: server=", count, " replay from ", from);
+
+            _resumePending = false;
+            uint8_t p[4];
+            writeU32LE(p, from);
+            sendBinary("", TYPE_SESSION, EV_SESSION_REPLAY, p, 4);
+            replayFrom(from);
+        }
+    }
+
+    void replayFrom(uint32_t seq) {
+        _sessionRing.forEachFrom(seq, &InstantIoTCoreBase::replayOne, this);
+    }
+
+    static bool replayOne(void* ctx, const uint8_t* frame, uint16_t len) {
+        return static_cast<InstantIoTCoreBase*>(ctx)->writeFrame(frame, len);
+    }
+    #endif
+
+    #if INSTANTIOT_CHART_HISTORY && INSTANTIOT_WIDGETS_ADVANCEDCHART
+    // Sketch side, like the samples pushed into the chart series
+    void chartTick() {
+        const uint32_t now = millis();
+        for (uint8_t i = 0; i < _chartCount; i++) _charts[i]->tick(now);
+    }
+
+    uint32_t chartDueMs() const {
+        const uint32_t now = millis();
+        uint32_t due = UINT32_MAX;
+        for (uint8_t i = 0; i < _chartCount; i++) due = minDue(due, _charts[i]->dueInMs(now));
+        return due;
+    }
+    #endif
+
+    #if INSTANTIOT_BATCH
+    // Sends captured by an open beginUpdate() scope
+    bool inBatchContext() const {
+        #if defined(ESP32) && (INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC)
+        return !xPortInIsrContext() && xTaskGetCurrentTaskHandle() == _batchTask;
+        #elif defined(__AVR__) && INSTANTIOT_TX_MPSC
+        return (SREG & 0x80) != 0;      // not from an ISR
+        #else
+        return true;
+        #endif
+    }
+
+    // Largest batch payload one frame can carry
+    size_t batchCapacity() {
+        const size_t room = maxPayloadLen("");
+        return room < sizeof(_batchBuf) ? room : sizeof(_batchBuf);
+    }
+
+    // Record: [type][event][widLen][wid][len:u16][payload]
+    bool batchAppend(const char* widgetId, uint8_t typeCode, uint8_t eventCode,
+                     const uint8_t* payloadBytes, size_t payloadLen) {
+        const size_t widLen = widgetId ? strlen(widgetId) : 0;
+        const size_t rec    = 5 + widLen + payloadLen;
+        if (widLen > 255) return false;
+        if (_batchLen + rec > batchCapacity() || _batchCount == 255) {
+            flushBatch();
+            if (1 + rec > batchCapacity()) {
+                // Too big for any batch: goes out alone, in order
+                const uint8_t depth = _batchDepth;
+                _batchDepth = 0;
+                const bool ok = sendBinary(widgetId, typeCode, eventCode, payloadBytes, payloadLen);
+                _batchDepth = depth;
+                return ok;
+            }
+        }
+        uint8_t* p = _batchBuf + _batchLen;
+        *p++ = typeCode;
+        *p++ = eventCode;
+        *p++ = (uint8_t)widLen;
+        memcpy(p, widgetId, widLen);                  p += widLen;
+        writeU16LE(p, (uint16_t)payloadLen);          p += 2;
+        if (payloadLen) memcpy(p, payloadBytes, payloadLen);
+        _batchLen += rec;
+        _batchCount++;
+        return true;
+    }
+
+    bool flushBatch() {
+        if (_batchCount == 0) return true;
+        const uint8_t depth = _batchDepth;
+        _batchDepth = 0;
+        bool ok;
+        char wid[INSTANTIOT_MAX_WIDGET_ID_LENGTH];
+        const uint8_t* p  = _batchBuf + 1;
+        const uint8_t  wl = p[2];
+        if (_batchCount == 1 && wl < sizeof(wid)) {
+            // Lone record: the plain frame is smaller
+            memcpy(wid, p + 3, wl);
+            wid[wl] = '\0';
+            const uint16_t len = readU16LE(p + 3 + wl);
+            ok = sendBinary(wid, p[0], p[1], len ? p + 5 + wl : nullptr, len);
+        } else {
+            _batchBuf[0] = _batchCount;
+            ok = sendBinary("", TYPE_BATCH, EV_BATCH_APPLY, _batchBuf, _batchLen);
+        }
+        if (!ok) invalidateBatch();
+        _batchDepth = depth;
+        _batchLen   = 1;
+        _batchCount = 0;
+        return ok;
+    }
+
+    // The widgets of a batch that was not sent counted their sends as
+    // delivered: same hooks as a connect edge, for those widgets only
+    void invalidateBatch() {
+        const uint8_t* p = _batchBuf + 1;
+        const uint8_t* const end = _batchBuf + _batchLen;
+        while (p + 5 <= end) {
+            const uint8_t wl = p[2];
+            invalidateSent(p[0], p + 3, wl);
+            p += 5 + wl + readU16LE(p + 3 + wl);
+        }
+    }
+
+    void invalidateSent(uint8_t typeCode, const uint8_t* wid, uint8_t wl) {
+        switch (typeCode) {
+            #if INSTANTIOT_WIDGETS_LED
+            case TYPE_LED:
+                if (LedWidget* w = findWidget(_leds, _ledCount, wid, wl)) w->invalidateAnimation();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_GAUGE
+            case TYPE_GAUGE:
+                if (GaugeWidget* w = findWidget(_gauges, _gaugeCount, wid, wl)) w->filter().reset();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_METRIC
+            case TYPE_METRIC:
+                if (MetricWidget* w = findWidget(_metrics, _metricCount, wid, wl)) w->filter().reset();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_HORIZONTALLEVEL
+            case TYPE_HLEVEL:
+                if (HorizontalLevelWidget* w = findWidget(_hLevels, _hLevelCount, wid, wl)) w->filter().reset();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_VERTICALLEVEL
+            case TYPE_VLEVEL:
+                if (VerticalLevelWidget* w = findWidget(_vLevels, _vLevelCount, wid, wl)) w->filter().reset();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_ADVANCEDCHART
+            case TYPE_ADVANCEDCHART:
+                if (AdvancedChartWidget* w = findWidget(_charts, _chartCount, wid, wl)) w->invalidateTimeBase();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_BARCHART && INSTANTIOT_BAR_DELTA
+            case TYPE_BARCHART:
+                if (BarChartWidget* w = findWidget(_barCharts, _barChartCount, wid, wl)) w->invalidateDelta();
+                break;
+            #endif
+            #if INSTANTIOT_WIDGETS_TEXT
+            case TYPE_TEXT:
+                if (TextWidget* w = findWidget(_texts, _textCount, wid, wl)) w->invalidateText();
+                break;
+            #endif
+            default: (void)wid; (void)wl; break;
+        }
+    }
+
+    // Widget of `list` whose id is the `wl` bytes at `wid` (not NUL-terminated)
+    template <typename W>
+    static W* findWidget(W* const* list, uint8_t count, const uint8_t* wid, uint8_t wl) {
+        for (uint8_t i = 0; i < count; i++) {
+            const char* id = list[i]->getId();
+            if (strlen(id) == wl && memcmp(id, wid, wl) == 0) return list[i];
+        }
+        return nullptr;
+    }
+    #endif
+
+    #if INSTANTIOT_STATE_RESYNC
+    // I/O side: arms on the connect edge, fires once nothing older is
+    // left to send
+    void resyncTick() {
+        if (!_resyncArmed || !_transport.connected()) return;
+        #if INSTANTIOT_SESSION_RESUME
+        if (_resumePending) return;
+        #endif
+        #if INSTANTIOT_OFFLINE_QUEUE
+        if (!_offline.empty()) return;
+        #endif
+        _resyncArmed = false;
+        requestResync();
+    }
+
+    void requestResync() {
+        #if INSTANTIOT_NETWORK_TASK
+        __atomic_store_n(&_resyncRequest, true, __ATOMIC_RELEASE);
+        if (_netTask && inNetworkTask()) xTaskNotifyGive(_ownerTask);   // wake idle()
+        #else
+        _resyncRequest = true;
+        #endif
+    }
+
+    bool resyncPending() const {
+        #if INSTANTIOT_NETWORK_TASK
+        return _resyncActive || __atomic_load_n(&_resyncRequest, __ATOMIC_ACQUIRE);
+        #else
+        return _resyncActive || _resyncRequest;
+        #endif
+    }
+
+    // Sketch side (widget state belongs to the loop() caller). With the
+    // network task, resumes on the next loop() when the TX ring is full.
+    void resyncStep() {
+        #if INSTANTIOT_NETWORK_TASK
+        const bool start = __atomic_exchange_n(&_resyncRequest, false, __ATOMIC_ACQ_REL);
+        #else
+        const bool start = _resyncRequest;
+        _resyncRequest = false;
+        #endif
+        if (start) { _resyncCursor = 0; _resyncActive = true; }
+        if (!_resyncActive) return;
+        #if INSTANTIOT_BATCH
+        beginUpdate();              // the burst leaves in as few frames as fit
+        #endif
+        while (DisplayWidget* w = displayWidgetAt(_resyncCursor)) {
+            #if INSTANTIOT_NETWORK_TASK
+            if (_netTask && TxQueue::capacity() - _txQueue.size() < DisplayWidget::RESYNC_MAX_FRAMES) break;
+            #endif
+            w->resync();
+            _resyncCursor++;
+        }
+        #if INSTANTIOT_BATCH
+        commit();
+        #endif
+        if (displayWidgetAt(_resyncCursor)) return;     // TX ring full: next loop()
+        _resyncActive = false;
+        IIOT_LOG_VAL("[Core] Resync done, widgets: ", _resyncCursor);
+    }
+
+    // All display widgets as one list, nullptr past the end
+    DisplayWidget* displayWidgetAt(uint16_t i) const {
+        #if INSTANTIOT_WIDGETS_LED
+        if (i < _ledCount) return _leds[i];
+        i -= _ledCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_GAUGE
+        if (i < _gaugeCount) return _gauges[i];
+        i -= _gaugeCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_METRIC
+        if (i < _metricCount) return _metrics[i];
+        i -= _metricCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_HORIZONTALLEVEL
+        if (i < _hLevelCount) return _hLevels[i];
+        i -= _hLevelCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_VERTICALLEVEL
+        if (i < _vLevelCount) return _vLevels[i];
+        i -= _vLevelCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_ADVANCEDCHART && INSTANTIOT_CHART_HISTORY
+        if (i < _chartCount) return _charts[i];     // restore() of the series windows
+        i -= _chartCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_BARCHART
+        if (i < _barChartCount) return _barCharts[i];
+        i -= _barChartCount;
+        #endif
+        #if INSTANTIOT_WIDGETS_TEXT
+        if (i < _textCount) return _texts[i];
+        #endif
+        (void)i;
+        return nullptr;
     }
 
+    bool          _resyncArmed   = false;   // I/O side
+    volatile bool _resyncRequest = false;   // I/O → sketch
+    bool          _resyncActive  = false;   // sketch side
+    uint16_t      _resyncCursor  = 0;
+    #endif
+
     #if INSTANTIOT_WIDGETS_LED
     LedWidget* _leds[INSTANTIOT_MAX_WIDGETS]; uint8_t _ledCount = 0;
     #endif
@@ -292,43 +1466,137 @@ protected:
     TextWidget* _texts[INSTANTIOT_MAX_WIDGETS]; uint8_t _textCount = 0;
     #endif
 
+    // ════════════════════════════════════════════════════════
+    // 🔄 I/O STEP — everything but the widget handlers
+    // ════════════════════════════════════════════════════════
+
+    void ioStep() {
+        {
+            IIOT_PHASE(PHASE_POLL);
+            _transport.poll();
+        }
+        checkConnection();
+        readLoop();
+        #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+        flushTxQueue();
+        #endif
+        #if INSTANTIOT_SESSION_RESUME
+        sessionTick();
+        #endif
+        #if INSTANTIOT_OFFLINE_QUEUE
+        offlineTick();
+        #endif
+        #if INSTANTIOT_STATE_RESYNC
+        resyncTick();
+        #endif
+        #if INSTANTIOT_TIME_SYNC
+        timeSyncTick();
+        #endif
+        #if INSTANTIOT_PING
+        pingTick();
+        #endif
+        #if INSTANTIOT_LINK_STATS
+        statsTick();
+        #endif
+        heartbeatTick();
+    }
+
     // ════════════════════════════════════════════════════════
     // 📥 READ — binary frame reassembly
     // ════════════════════════════════════════════════════════
 
     void readLoop() {
+        #if INSTANTIOT_LOOP_STATS
+        // Only loops that actually received something are sampled
+        if (_transport.available() > 0) {
+            IIOT_PHASE(PHASE_RX_DRAIN);
+            drainTransport();
+        }
+        #else
+        drainTransport();
+        #endif
+        extractFrames();
+    }
+
+    void drainTransport() {
         while (_transport.available() > 0) {
             uint8_t buf[64];
-            int n = _transport.read(buf, sizeof(buf));
+            size_t want = sizeof(buf);
+            #if INSTANTIOT_DEFERRED_DISPATCH
+            // Never read more than fits: the rest stays in the transport
+            const size_t room = sizeof(_rxBuffer) - _rxPos;
+            if (room == 0) break;
+            if (want > room) want = room;
+            #endif
+            int n = _transport.read(buf, want);
             if (n <= 0) break;
+            IIOT_STAT(_linkStats.bytesIn += (uint32_t)n);
             for (int i = 0; i < n; i++) {
                 if (_rxPos < sizeof(_rxBuffer)) {
                     _rxBuffer[_rxPos++] = buf[i];
                 } else {
+                    IIOT_TRACE(TRACE_RX_OVERFLOW, 0, _rxPos);
                     _rxPos = 0;
+                    IIOT_STAT(_linkStats.rxOverflows++);
                     IIOT_LOG("[Core] RX overflow, reset");
                 }
             }
         }
-        extractFrames();
     }
 
     void extractFrames() {
+        #if INSTANTIOT_LOOP_STATS
+        if (_rxPos < 5) return;
+        const uint32_t t0 = micros();
+        _frameUs = 0;
+        #endif
+        #if INSTANTIOT_RX_COALESCE
+        _coalescer.reset();
+        #endif
         // Header = AA + VER + LEN(2) = 4 bytes. Min frame = header + CRC = 5 bytes.
         while (_rxPos >= 5) {
-            if (_rxBuffer[0] != 0xAA) { shiftBuffer(1); continue; }
-            if (_rxBuffer[1] != 0x01) { shiftBuffer(1); continue; }
+            if (_rxBuffer[0] != 0xAA) { skipByte(); continue; }
+            if (_rxBuffer[1] != 0x01) { skipByte(); continue; }
 
             uint16_t len = (uint16_t)_rxBuffer[2] | ((uint16_t)_rxBuffer[3] << 8);
             // sanity guard: header(4) + body(len) + crc(1) must fit in the buffer
-            if (len > sizeof(_rxBuffer) - 5) { shiftBuffer(1); continue; }
+            if (len > sizeof(_rxBuffer) - 5) { skipByte(); continue; }
             uint16_t frameSize = 4 + len + 1;  // header(4) + body(len) + crc(1)
 
             if (_rxPos < frameSize) break;
 
+            #if INSTANTIOT_TRACE
+            // One record per run of skipped bytes, not one per byte
+            if (_resyncRun) { IIOT_TRACE(TRACE_RESYNC, 0, _resyncRun); _resyncRun = 0; }
+            #endif
+            #if INSTANTIOT_RX_COALESCE
+            if (_coalescer.superseded(_rxBuffer, _rxPos)) {
+                IIOT_STAT(_linkStats.coalesced++);
+                IIOT_TRACE(TRACE_COALESCED, 0, frameSize);
+                shiftBuffer(frameSize);
+                continue;
+            }
+            #endif
+            #if INSTANTIOT_DEFERRED_DISPATCH
+            // Backpressure: the frame waits until handlers catch up
+            if (_events.full()) break;
+            #endif
             processFrame(_rxBuffer, frameSize);
             shiftBuffer(frameSize);
         }
+        #if INSTANTIOT_LOOP_STATS
+        // Framing only: decode and dispatch have their own phases
+        _loopStats.add(PHASE_EXTRACT, micros() - t0 - _frameUs);
+        #endif
+    }
+
+    // Resync: drop one byte and look for the next frame start
+    void skipByte() {
+        IIOT_STAT(_linkStats.resyncBytes++);
+        #if INSTANTIOT_TRACE
+        _resyncRun++;
+        #endif
+        shiftBuffer(1);
     }
 
     void shiftBuffer(size_t n) {
@@ -340,8 +1608,212 @@ protected:
     void processFrame(const uint8_t* data, size_t len) {
         DecodedMessage msg;
         uint8_t typeCode = 0, eventCode = 0;
-        if (!_codec.decode(data, len, msg, typeCode, eventCode)) return;
-        WidgetRegistry::dispatch(typeCode, msg.widgetId, eventCode, msg);
+        #if INSTANTIOT_LOOP_STATS
+        const uint32_t t0 = micros();
+        #endif
+        const bool ok = _codec.decode(data, len, msg, typeCode, eventCode);
+        #if INSTANTIOT_LOOP_STATS
+        const uint32_t t1 = micros();
+        _loopStats.add(PHASE_DECODE, t1 - t0);
+        _frameUs += t1 - t0;
+        #endif
+        if (!ok) {
+            IIOT_STAT(_linkStats.decodeErrors++);
+            IIOT_TRACE(TRACE_DECODE_ERROR, 0, len);
+            return;
+        }
+        IIOT_STAT(_linkStats.framesIn++);
+        IIOT_TRACE(TRACE_RX_FRAME, typeCode, len);
+        #if INSTANTIOT_DEFERRED_DISPATCH
+        if (!isServiceType(typeCode)) { deferEvent(typeCode, eventCode, msg); return; }
+        #endif
+        IIOT_TRACE(TRACE_DISPATCH, typeCode, eventCode);
+        #if INSTANTIOT_TRACE
+        const uint32_t td = micros();
+        #endif
+
+        if (!handleServiceFrame(typeCode, eventCode, msg))
+            WidgetRegistry::dispatch(typeCode, msg.widgetId, eventCode, msg);
+
+        #if INSTANTIOT_TRACE
+        const uint32_t dt = micros() - td;
+        IIOT_TRACE(TRACE_DISPATCH_END, typeCode, dt > 0xFFFF ? 0xFFFF : dt);
+        #endif
+        #if INSTANTIOT_LOOP_STATS
+        const uint32_t t2 = micros();
+        // With the network task the dispatch histograms belong to the
+        // sketch side (dispatchPending()): one writer only
+        if (!netTaskRunning()) _loopStats.addDispatch(typeCode, t2 - t1);
+        _frameUs += t2 - t1;
+        #endif
+    }
+
+    #if INSTANTIOT_DEFERRED_DISPATCH
+    // extractFrames() checked that a slot is free
+    void deferEvent(uint8_t typeCode, uint8_t eventCode, const DecodedMessage& msg) {
+        AnyEvent e;
+        if (!WidgetRegistry::decode(typeCode, msg.widgetId, eventCode, msg, e)) return;
+        QueuedEvent* q = _events.beginPush();
+        if (!q) return;
+        q->assign(e, typeCode, eventCode);
+        _events.endPush();
+        #if INSTANTIOT_NETWORK_TASK
+        if (_netTask) xTaskNotifyGive(_ownerTask);
+        #endif
+    }
+    #endif
+
+    bool netTaskRunning() const {
+        #if INSTANTIOT_NETWORK_TASK
+        return _netTask != nullptr;
+        #else
+        return false;
+        #endif
+    }
+
+    #if INSTANTIOT_NETWORK_TASK
+    // ════════════════════════════════════════════════════════
+    // 🛰️ NETWORK TASK
+    // ════════════════════════════════════════════════════════
+
+    bool inNetworkTask() const { return xTaskGetCurrentTaskHandle() == _netTask; }
+
+    void startNetworkTask() {
+        if (_netTask) return;
+        BaseType_t ok = xTaskCreatePinnedToCore(
+            networkTaskEntry, "iiot-net", INSTANTIOT_NET_TASK_STACK, this,
+            INSTANTIOT_NET_TASK_PRIORITY, &_netTask, INSTANTIOT_NET_TASK_CORE);
+        if (ok != pdPASS) {
+            _netTask = nullptr;
+            IIOT_LOG("[Core] Network task FAILED, I/O stays in loop()");
+        }
+    }
+
+    static void networkTaskEntry(void* self) {
+        static_cast<InstantIoTCoreBase*>(self)->networkTaskLoop();
+    }
+
+    void networkTaskLoop() {
+        for (;;) {
+            {
+                IIOT_PHASE(PHASE_LOOP);
+                ioStep();
+            }
+            // Events full: RX is stalled until the sketch catches up
+            uint32_t ms = _events.full() ? 1 : idleBudgetMs(INSTANTIOT_NET_TASK_WAIT_MS);
+            if (!_txQueue.empty()) ms = 0;
+            if (ms == 0) { vTaskDelay(1); continue; }   // let the core's idle task run
+            if (_transport.waitForData(ms) < 0) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+        }
+    }
+    #endif
+
+    #if INSTANTIOT_NETWORK_TASK || INSTANTIOT_TX_MPSC
+    // ════════════════════════════════════════════════════════
+    // 📤 TX QUEUE
+    // ════════════════════════════════════════════════════════
+
+    /** True where the transport may be written directly. */
+    bool onIoContext() const {
+        #if INSTANTIOT_NETWORK_TASK
+        if (_netTask) return inNetworkTask();
+        #endif
+        #if !INSTANTIOT_TX_MPSC
+        return true;
+        #elif defined(ESP32)
+        return !xPortInIsrContext() && xTaskGetCurrentTaskHandle() == _ownerTask;
+        #elif defined(__AVR__)
+        return (SREG & 0x80) != 0;      // interrupts off: ISR (or critical section)
+        #else
+        return true;
+        #endif
+    }
+
+    // Producer side of sendBinary(): encode into a TX queue slot
+    bool queueTx(
+        const char* widgetId,
+        uint8_t typeCode,
+        uint8_t eventCode,
+        const uint8_t* payloadBytes,
+        size_t payloadLen
+    ) {
+        TxFrame* f = _txQueue.beginPush();
+        #if defined(ESP32) && INSTANTIOT_TX_QUEUE_WAIT_MS > 0
+        // Full: a task (never an ISR) waits a bounded time for the I/O
+        // side to drain — select() in the network task is not woken by
+        // the notification, it returns within INSTANTIOT_NET_TASK_WAIT_MS
+        if (!f && !xPortInIsrContext()) {
+            TickType_t ticks = pdMS_TO_TICKS(INSTANTIOT_TX_QUEUE_WAIT_MS);
+            if (ticks == 0) ticks = 1;
+            do {
+                #if INSTANTIOT_NETWORK_TASK
+                if (_netTask) xTaskNotifyGive(_netTask);
+                #endif
+                vTaskDelay(1);
+            } while (!(f = _txQueue.beginPush()) && --ticks);
+        }
+        #endif
+        if (!f) { atomicIncrement(_txQueueDrops); return false; }
+        size_t len = _codec.encode(
+            f->bytes, sizeof(f->bytes),
+            _config.getDeviceId(),
+            widgetId,
+            typeCode,
+            eventCode,
+            payloadBytes,
+            payloadLen
+        );
+        f->len      = (uint16_t)len;    // a claimed slot is always published
+        f->typeCode = typeCode;
+        _txQueue.endPush(f);
+        if (len == 0) { atomicIncrement(_txQueueDrops); return false; }
+        #if INSTANTIOT_NETWORK_TASK
+        if (_netTask) {
+            if (xPortInIsrContext()) vTaskNotifyGiveFromISR(_netTask, nullptr);
+            else                     xTaskNotifyGive(_netTask);
+        }
+        #endif
+        return true;
+    }
+
+    // I/O side: same path as sendBinary() after encoding
+    void flushTxQueue() {
+        while (TxFrame* f = _txQueue.front()) {
+            if (f->len) {
+                checkConnection();
+                const bool online = _transport.connected();
+                const bool queue  = shouldQueueOffline(f->typeCode, online);
+                if (!online && !queue) IIOT_STAT(_linkStats.txDropped++);
+                #if INSTANTIOT_OFFLINE_QUEUE
+                else if (queue) _offline.append(f->bytes, f->len);
+                #endif
+                else emitFrame(f->bytes, f->len, isDataType(f->typeCode));
+            }
+            _txQueue.pop();
+        }
+    }
+    #endif
+
+    /**
+     * Service frames (TYPE 0xF0..0xFF) are consumed by the core and
+     * never dispatched to user code.
+     * @return true if the frame was a service frame
+     */
+    bool handleServiceFrame(uint8_t typeCode, uint8_t eventCode, const DecodedMessage& msg) {
+        if (!isServiceType(typeCode)) return false;
+        switch (typeCode) {
+            #if INSTANTIOT_SESSION_RESUME
+            case TYPE_SESSION: handleSessionFrame(eventCode, msg); break;
+            #endif
+            #if INSTANTIOT_TIME_SYNC
+            case TYPE_TIMESYNC: handleTimeSyncFrame(eventCode, msg); break;
+            #endif
+            #if INSTANTIOT_PING
+            case TYPE_PING: handlePingFrame(eventCode, msg); break;
+            #endif
+            default: (void)eventCode; (void)msg; break;
+        }
+        return true;
     }
 };
 
@@ -0,0 +1,66 @@
+#pragma once
+/**
+ * ============================================================
+ * 📬 InstantIoTEventQueue.hpp — Deferred widget events
+ * ============================================================
+ *
+ * With INSTANTIOT_DEFERRED_DISPATCH, frame parsing no longer runs user
+ * handlers: each widget frame is decoded to its typed event
+ * (WidgetRegistry::decode) and copied into a QueuedEvent, which owns
+ * its strings. InstantIoTCoreBase::dispatchPending() delivers them
+ * later, under a time budget.
+ *
+ * RAM: INSTANTIOT_EVENT_QUEUE_SIZE × sizeof(QueuedEvent), about
+ * 130 B per slot with the default string lengths.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "InstantIoTMessage.hpp"
+#include "InstantIoTSpscRing.hpp"
+
+namespace InstantIoT {
+
+struct QueuedEvent {
+    AnyEvent event;
+    uint8_t  typeCode;
+    uint8_t  eventCode;
+    char     widgetId[INSTANTIOT_MAX_WIDGET_ID_LENGTH];
+    char     text[INSTANTIOT_EVENT_TEXT_LENGTH];   // SegmentedSwitch selectedIds
+
+    /** Copies `e`, strings included (truncated to the buffers). */
+    void assign(const AnyEvent& e, uint8_t type, uint8_t ev) {
+        event     = e;
+        typeCode  = type;
+        eventCode = ev;
+        copy(widgetId, sizeof(widgetId), e.simpleButton.widgetId);
+        text[0] = '\0';
+        if (e.kind == AnyEvent::SegmentedSwitch) {
+            if (e.segmentedSwitch.selectedIds)
+                copy(text, sizeof(text), e.segmentedSwitch.selectedIds);
+            event.segmentedSwitch.segmentId = nullptr;  // not carried by binary frames
+        }
+    }
+
+    /** The event, its string members pointing into this slot. */
+    const AnyEvent& get() {
+        // widgetId leads every event struct (common initial sequence)
+        event.simpleButton.widgetId = widgetId;
+        if (event.kind == AnyEvent::SegmentedSwitch && event.segmentedSwitch.selectedIds)
+            event.segmentedSwitch.selectedIds = text;
+        return event;
+    }
+
+private:
+    static void copy(char* dst, size_t cap, const char* src) {
+        strncpy(dst, src ? src : "", cap - 1);
+        dst[cap - 1] = '\0';
+    }
+};
+
+typedef SpscRing<QueuedEvent, INSTANTIOT_EVENT_QUEUE_SIZE> EventQueue;
+
+} // namespace InstantIoT
@@ -0,0 +1,61 @@
+#pragma once
+/**
+ * ============================================================
+ * 📊 InstantIoTLinkStats.hpp — Link health counters
+ * ============================================================
+ *
+ * Counters kept by the core (bytes, frames, errors), merged in
+ * `InstantIoTCoreBase::linkStats()` with the codec CRC count and the
+ * transport's own TransportStats. All counters are cumulative since
+ * boot or the last `resetLinkStats()`, and wrap at 2^32.
+ *
+ * Diagnostic frame (TYPE_STATS / EV_STATS_REPORT), Device → Server:
+ *   [VERSION=1 | COUNT | u32 LE × COUNT]  fields in declaration order.
+ * New fields are only ever appended, so a reader skips what it does
+ * not know.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include "BinaryCodec.hpp"
+
+namespace InstantIoT {
+
+struct LinkStats {
+    uint32_t bytesIn;            // read from the transport
+    uint32_t bytesOut;           // accepted by transport.write()
+    uint32_t framesIn;           // frames decoded
+    uint32_t framesOut;          // frames fully written
+    uint32_t crcErrors;          // frames dropped on CRC mismatch
+    uint32_t decodeErrors;       // frames dropped by decode() (CRC included)
+    uint32_t rxOverflows;        // RX buffer resets in readLoop
+    uint32_t resyncBytes;        // bytes skipped looking for a frame start
+    uint32_t shortWrites;        // write() took fewer bytes than the frame
+    uint32_t txDropped;          // sendBinary() refused (offline / encode)
+    uint32_t connects;           // connection edges seen by the core
+    uint32_t disconnects;
+    uint32_t reconnectAttempts;  // from TransportStats
+    uint32_t reconnectFailures;  // from TransportStats
+    uint32_t coalesced;          // continuous frames skipped (RX coalescing)
+    uint32_t txQueueDrops;       // sends refused by the TX queue (full / too large)
+
+    static const uint8_t VERSION     = 1;
+    static const uint8_t FIELD_COUNT = 16;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    /** Diagnostic frame payload, `out` ≥ 2 + 4 × FIELD_COUNT bytes. */
+    size_t encode(uint8_t* out) const {
+        const uint32_t* f = &bytesIn;
+        out[0] = VERSION;
+        out[1] = FIELD_COUNT;
+        for (uint8_t i = 0; i < FIELD_COUNT; i++) writeU32LE(out + 2 + i * 4, f[i]);
+        return 2 + (size_t)FIELD_COUNT * 4;
+    }
+};
+
+static_assert(sizeof(LinkStats) == LinkStats::FIELD_COUNT * 4, "LinkStats: u32 fields only");
+
+} // namespace InstantIoT
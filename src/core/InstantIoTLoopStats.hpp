@@ -0,0 +1,183 @@
+#pragma once
+/**
+ * ============================================================
+ * ⏲️ InstantIoTLoopStats.hpp — Per-phase loop latency histograms
+ * ============================================================
+ *
+ * Each phase of `InstantIoTCoreBase::loop()` is timed with micros()
+ * and recorded in a log2-bucketed histogram: bucket b counts the
+ * samples in [2^(b-1), 2^b) µs (bucket 0 = under 1 µs, the last one
+ * catches everything above). Recording is a CLZ + an increment, so
+ * the probe does not distort what it measures.
+ *
+ * Phases:
+ *   LOOP      whole loop() call
+ *   POLL      _transport.poll() (reconnects show up here)
+ *   RX_DRAIN  reading available bytes into the RX buffer
+ *   EXTRACT   frame sync + length checks (decode/dispatch excluded)
+ *   DECODE    BinaryCodec::decode of one frame
+ *   DISPATCH  service handler or Registry dispatch of one frame
+ *             (also kept per widget type, see dispatchFor())
+ *   TX_WRITE  _transport.write() of one frame
+ *
+ * Percentiles are read from the buckets, so they are upper bounds
+ * within a factor of 2; `maxUs` is exact.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include <stdio.h>
+#include "../InstantIoTConfig.h"
+
+namespace InstantIoT {
+
+enum LoopPhase : uint8_t {
+    PHASE_LOOP = 0,
+    PHASE_POLL,
+    PHASE_RX_DRAIN,
+    PHASE_EXTRACT,
+    PHASE_DECODE,
+    PHASE_DISPATCH,
+    PHASE_TX_WRITE,
+    PHASE_COUNT
+};
+
+struct LatencyHistogram {
+    static const uint8_t BUCKETS = INSTANTIOT_LOOP_STATS_BUCKETS;
+
+    uint32_t buckets[BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void add(uint32_t us) {
+        uint8_t b = (us == 0) ? 0 : (uint8_t)(32 - __builtin_clz(us));
+        if (b >= BUCKETS) b = BUCKETS - 1;
+        buckets[b]++;
+        count++;
+        totalUs += us;
+        if (us > maxUs) maxUs = us;
+    }
+
+    uint32_t avgUs() const { return count ? (uint32_t)(totalUs / count) : 0; }
+
+    /** Upper bound of the bucket holding the `pct` percentile (µs). */
+    uint32_t percentileUs(uint8_t pct) const {
+        if (count == 0) return 0;
+        uint32_t rank = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+        if (rank == 0) rank = 1;
+        uint32_t seen = 0;
+        for (uint8_t b = 0; b < BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                if (b == BUCKETS - 1) return maxUs;
+                uint32_t upper = (uint32_t)1 << b;
+                return upper < maxUs ? upper : maxUs;
+            }
+        }
+        return maxUs;
+    }
+};
+
+class LoopStats {
+public:
+    LoopStats() { reset(); }
+
+    void reset() {
+        for (uint8_t i = 0; i < PHASE_COUNT; i++) _phase[i].reset();
+        for (uint8_t i = 0; i < INSTANTIOT_LOOP_STATS_TYPES; i++) {
+            _types[i].hist.reset();
+            _types[i].used = false;
+        }
+    }
+
+    void add(LoopPhase p, uint32_t us) { _phase[p].add(us); }
+
+    void addDispatch(uint8_t typeCode, uint32_t us) {
+        _phase[PHASE_DISPATCH].add(us);
+        LatencyHistogram* h = slotFor(typeCode);
+        if (h) h->add(us);
+    }
+
+    const LatencyHistogram& phase(LoopPhase p) const { return _phase[p]; }
+
+    /** Dispatch histogram of one widget type, nullptr if never seen. */
+    const LatencyHistogram* dispatchFor(uint8_t typeCode) const {
+        for (uint8_t i = 0; i < INSTANTIOT_LOOP_STATS_TYPES; i++) {
+            if (_types[i].used && _types[i].type == typeCode) return &_types[i].hist;
+        }
+        return nullptr;
+    }
+
+    static const char* phaseName(LoopPhase p) {
+        static const char* const names[PHASE_COUNT] = {
+            "loop", "poll", "rx", "extract", "decode", "dispatch", "tx"
+        };
+        return p < PHASE_COUNT ? names[p] : "?";
+    }
+
+    /**
+     * One line per phase, "name p50/p99/max" in µs. Phases without
+     * samples are skipped. Truncated to `cap` (always terminated).
+     * @return length written
+     */
+    size_t format(char* out, size_t cap) const {
+        if (cap == 0) return 0;
+        size_t n = 0;
+        out[0] = '\0';
+        for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+            const LatencyHistogram& h = _phase[i];
+            if (h.count == 0) continue;
+            int w = snprintf(out + n, cap - n, "%s%s %lu/%lu/%lu",
+                             n ? "\n" : "", phaseName((LoopPhase)i),
+                             (unsigned long)h.percentileUs(50),
+                             (unsigned long)h.percentileUs(99),
+                             (unsigned long)h.maxUs);
+            if (w < 0 || (size_t)w >= cap - n) { out[n] = '\0'; break; }
+            n += (size_t)w;
+        }
+        return n;
+    }
+
+private:
+    struct TypeSlot {
+        LatencyHistogram hist;
+        uint8_t type;
+        bool    used;
+    };
+
+    LatencyHistogram _phase[PHASE_COUNT];
+    TypeSlot         _types[INSTANTIOT_LOOP_STATS_TYPES];
+
+    // Types beyond INSTANTIOT_LOOP_STATS_TYPES only feed PHASE_DISPATCH
+    LatencyHistogram* slotFor(uint8_t typeCode) {
+        for (uint8_t i = 0; i < INSTANTIOT_LOOP_STATS_TYPES; i++) {
+            if (!_types[i].used) {
+                _types[i].used = true;
+                _types[i].type = typeCode;
+                return &_types[i].hist;
+            }
+            if (_types[i].type == typeCode) return &_types[i].hist;
+        }
+        return nullptr;
+    }
+};
+
+/** Records the lifetime of the scope into one phase. */
+class PhaseTimer {
+public:
+    PhaseTimer(LoopStats& stats, LoopPhase p)
+        : _stats(stats), _phase(p), _t0(micros()) {}
+    ~PhaseTimer() { _stats.add(_phase, micros() - _t0); }
+private:
+    LoopStats& _stats;
+    LoopPhase  _phase;
+    uint32_t   _t0;
+};
+
+} // namespace InstantIoT
@@ -197,6 +197,42 @@ struct SegmentedSwitchEvent {
     bool isSegmentDeselected() const { return kind == SegmentedEventKind::SegmentDeselected; }
 };
 
+// ============================================================
+// 📦 ANY EVENT — one typed event, tagged by widget kind
+// ============================================================
+//
+// Output of WidgetRegistry::decode(), input of WidgetRegistry::deliver().
+// String members still point to the decoder's buffers: copy it with
+// QueuedEvent (core/InstantIoTEventQueue.hpp) to keep it past the frame.
+
+struct AnyEvent {
+    enum Kind : uint8_t {
+        None = 0,
+        SimpleButton,
+        AdvancedButton,
+        EmergencyButton,
+        HorizontalSlider,
+        VerticalSlider,
+        Switch,
+        Joystick,
+        DirectionPad,
+        SegmentedSwitch
+    };
+
+    Kind kind;
+    union {
+        SimpleButtonEvent     simpleButton;
+        AdvancedButtonEvent   advancedButton;
+        EmergencyButtonEvent  emergencyButton;
+        HorizontalSliderEvent horizontalSlider;
+        VerticalSliderEvent   verticalSlider;
+        SwitchEvent           switchEvent;
+        JoystickEvent         joystick;
+        DirectionPadEvent     directionPad;
+        SegmentedSwitchEvent  segmentedSwitch;
+    };
+};
+
 } // namespace InstantIoT
 
 // ============================================================
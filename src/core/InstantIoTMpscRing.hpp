@@ -0,0 +1,143 @@
+#pragma once
+/**
+ * ============================================================
+ * 🔀 InstantIoTMpscRing.hpp — Bounded multi-producer / single-consumer ring
+ * ============================================================
+ *
+ * Same in-place API as SpscRing, but any number of producers — tasks on
+ * either core, ISRs — may push concurrently, lock-free:
+ *
+ *   T* slot = ring.beginPush();      // nullptr when full
+ *   if (slot) { fill(*slot); ring.endPush(slot); }
+ *
+ * Each cell carries a sequence number (bounded MPMC design by D. Vyukov):
+ * a producer claims a cell with one CAS on the head index, fills it,
+ * then publishes it by bumping the cell's sequence. The consumer only
+ * takes cells whose sequence says "published", so a half-filled cell is
+ * never read. A producer preempted between claim and publish delays the
+ * consumer (cells are delivered in claim order) but never corrupts it.
+ *
+ * Every claimed cell MUST be published, even if the producer has
+ * nothing to put in it: mark it empty instead.
+ *
+ * On AVR (no CAS instruction) the claim runs with interrupts disabled
+ * for a few cycles; indices are 8-bit there.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace InstantIoT {
+
+#if defined(__AVR__)
+typedef uint8_t MpscIndex;
+
+inline bool mpscCas(volatile MpscIndex& v, MpscIndex& expected, MpscIndex desired) {
+    const uint8_t sreg = SREG;
+    cli();
+    const bool ok = (v == expected);
+    if (ok) v = desired; else expected = v;
+    SREG = sreg;
+    return ok;
+}
+#define IIOT_MPSC_LOAD(v)      (v)
+#define IIOT_MPSC_STORE(v, x)  ((v) = (x))
+
+/** Counter bumped from any context (tasks, ISRs). */
+inline void atomicIncrement(volatile uint32_t& v) {
+    const uint8_t sreg = SREG;
+    cli();
+    v++;
+    SREG = sreg;
+}
+#else
+typedef uint32_t MpscIndex;
+
+inline bool mpscCas(volatile MpscIndex& v, MpscIndex& expected, MpscIndex desired) {
+    return __atomic_compare_exchange_n(&v, &expected, desired, true,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+#define IIOT_MPSC_LOAD(v)      __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define IIOT_MPSC_STORE(v, x)  __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
+/** Counter bumped from any context (tasks, ISRs). */
+inline void atomicIncrement(volatile uint32_t& v) {
+    __atomic_fetch_add(&v, 1, __ATOMIC_RELAXED);
+}
+#endif
+
+template<typename T, size_t N>
+class MpscRing {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing: N must be a power of 2");
+    static_assert(N <= ((MpscIndex)~(MpscIndex)0 >> 2), "MpscRing: N too large for the index type");
+
+    MpscRing() {
+        for (size_t i = 0; i < N; i++) _cells[i].seq = (MpscIndex)i;
+    }
+
+    // ─── Producer side (any context) ─────────────────────────
+
+    /** Claims a free slot, or nullptr if the ring is full. */
+    T* beginPush() {
+        MpscIndex pos = IIOT_MPSC_LOAD(_head);
+        for (;;) {
+            Cell& c = _cells[pos & (N - 1)];
+            const MpscIndex seq = IIOT_MPSC_LOAD(c.seq);
+            const MpscIndex dif = (MpscIndex)(seq - pos);
+            if (dif == 0) {
+                if (mpscCas(_head, pos, (MpscIndex)(pos + 1))) return &c.value;
+                // lost the race: `pos` now holds the current head
+            } else if (dif & ((MpscIndex)1 << (sizeof(MpscIndex) * 8 - 1))) {
+                return nullptr;                      // seq behind pos: full
+            } else {
+                pos = IIOT_MPSC_LOAD(_head);         // another producer moved on
+            }
+        }
+    }
+
+    /** Publishes a slot returned by beginPush(). */
+    void endPush(T* slot) {
+        Cell* c = reinterpret_cast<Cell*>(slot);
+        IIOT_MPSC_STORE(c->seq, (MpscIndex)(c->seq + 1));
+    }
+
+    // ─── Consumer side (one context) ─────────────────────────
+
+    /** Oldest published slot, or nullptr (empty, or next one still being filled). */
+    T* front() {
+        Cell& c = _cells[_tail & (N - 1)];
+        if (IIOT_MPSC_LOAD(c.seq) != (MpscIndex)(_tail + 1)) return nullptr;
+        return &c.value;
+    }
+
+    /** Releases the slot returned by front() for reuse. */
+    void pop() {
+        Cell& c = _cells[_tail & (N - 1)];
+        IIOT_MPSC_STORE(c.seq, (MpscIndex)(_tail + N));
+        _tail++;
+    }
+
+    /** Snapshot: claimed slots not yet released (filled or not). */
+    size_t size() const {
+        return (MpscIndex)(IIOT_MPSC_LOAD(_head) - _tail);
+    }
+    bool empty() const { return size() == 0; }
+    static size_t capacity() { return N; }
+
+private:
+    struct Cell {
+        T                  value;   // first: endPush() maps a slot back to its cell
+        volatile MpscIndex seq;
+    };
+
+    Cell               _cells[N];
+    volatile MpscIndex _head = 0;   // next cell to claim (producers, CAS)
+    MpscIndex          _tail = 0;   // next cell to read (consumer only)
+};
+
+} // namespace InstantIoT
@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * ============================================================
+ * 🛰️ InstantIoTNetTask.hpp — Network task plumbing (ESP32)
+ * ============================================================
+ *
+ * With INSTANTIOT_NETWORK_TASK, InstantIoTCoreBase runs its I/O in a
+ * FreeRTOS task pinned to INSTANTIOT_NET_TASK_CORE and talks to the
+ * sketch through two rings:
+ *
+ *   network task ── EventQueue ──▶ sketch loop()  (dispatchPending)
+ *   sketch       ── TxQueue    ──▶ network task   (encoded frames)
+ *
+ * Without INSTANTIOT_TX_MPSC the TX ring has exactly one producer:
+ * widget setters and sendBinary() must then be called from one task
+ * only (normally the Arduino loop task, handlers included). Frames the
+ * core emits itself (heartbeat, ping, session...) are written directly
+ * by the network task.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "InstantIoTTxQueue.hpp"
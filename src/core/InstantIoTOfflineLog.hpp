@@ -0,0 +1,347 @@
+#pragma once
+/**
+ * ============================================================
+ * 💾 InstantIoTOfflineLog.hpp — Store-and-forward frame log
+ * ============================================================
+ *
+ * Bounded log of encoded frames kept in flash while the transport is
+ * down, drained at a controlled rate once it is back.
+ *
+ * Storage = N fixed-size segments used in a circle. Each segment is a
+ * flat little-endian file, readable as-is (or mmap'ed) on a host:
+ *
+ *   [MAGIC "IIOL"(4B) | GEN(4B LE)]                       segment header
+ *   [LEN(2B LE) | CRC8(1B) | FRAME_BYTES] × n             records
+ *
+ * GEN increases each time a segment is (re)started: at boot the oldest
+ * non-empty segment (lowest GEN) is the read side, the newest is the
+ * write side. CRC8 is the frame CRC-8/SMBUS; a torn record (power loss
+ * during a write) ends the segment.
+ *
+ * Wear: segments are rewritten strictly round-robin, so erase cycles
+ * spread evenly; appends are staged in RAM and flushed in one write
+ * (INSTANTIOT_OFFLINE_STAGING bytes, or after INSTANTIOT_OFFLINE_FLUSH_MS).
+ * When every segment is full, the oldest segment is dropped.
+ *
+ * Delivery is at-least-once across a reboot: the read position inside
+ * the current segment is RAM-only, a segment is erased once fully drained.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "../InstantIoTConfig.h"
+#include "BinaryCodec.hpp"
+
+namespace InstantIoT {
+
+/**
+ * Segment storage backend. Segments are append-only byte files
+ * identified by their index (0..INSTANTIOT_OFFLINE_SEGMENTS-1).
+ */
+struct IOfflineStorage {
+    virtual ~IOfflineStorage() = default;
+
+    /** @return bytes stored in the segment, 0 if absent */
+    virtual size_t size(uint8_t seg) = 0;
+
+    /** @return bytes actually read */
+    virtual size_t read(uint8_t seg, size_t offset, uint8_t* buf, size_t len) = 0;
+
+    virtual bool append(uint8_t seg, const uint8_t* buf, size_t len) = 0;
+
+    /** Empties the segment (size → 0) */
+    virtual bool erase(uint8_t seg) = 0;
+};
+
+/**
+ * Backend on top of stdio files: `<prefix><seg>.bin`.
+ *
+ * Works on ESP32 through the VFS once the filesystem is mounted
+ * (e.g. `LittleFS.begin(true)` then prefix "/littlefs/iiotq"),
+ * and unchanged on a host filesystem.
+ */
+class FileOfflineStorage : public IOfflineStorage {
+public:
+    explicit FileOfflineStorage(const char* prefix) : _prefix(prefix) {}
+
+    size_t size(uint8_t seg) override {
+        FILE* f = open(seg, "rb");
+        if (!f) return 0;
+        fseek(f, 0, SEEK_END);
+        long n = ftell(f);
+        fclose(f);
+        return n > 0 ? (size_t)n : 0;
+    }
+
+    size_t read(uint8_t seg, size_t offset, uint8_t* buf, size_t len) override {
+        FILE* f = open(seg, "rb");
+        if (!f) return 0;
+        size_t n = 0;
+        if (fseek(f, (long)offset, SEEK_SET) == 0) n = fread(buf, 1, len, f);
+        fclose(f);
+        return n;
+    }
+
+    bool append(uint8_t seg, const uint8_t* buf, size_t len) override {
+        FILE* f = open(seg, "ab");
+        if (!f) return false;
+        size_t n = fwrite(buf, 1, len, f);
+        fclose(f);
+        return n == len;
+    }
+
+    bool erase(uint8_t seg) override {
+        FILE* f = open(seg, "wb");
+        if (!f) return false;
+        fclose(f);
+        return true;
+    }
+
+private:
+    const char* _prefix;
+
+    FILE* open(uint8_t seg, const char* mode) {
+        char path[64];
+        snprintf(path, sizeof(path), "%s%u.bin", _prefix, (unsigned)seg);
+        return fopen(path, mode);
+    }
+};
+
+static_assert(INSTANTIOT_OFFLINE_SEGMENTS >= 2, "OfflineLog needs at least 2 segments");
+
+class OfflineLog {
+public:
+    static const uint8_t  SEGMENTS    = INSTANTIOT_OFFLINE_SEGMENTS;
+    static const size_t   HEADER_SIZE = 8;
+    static const size_t   RECORD_HDR  = 3;   // LEN(2) + CRC8(1)
+
+    OfflineLog() {}
+
+    /**
+     * Attaches the storage and rebuilds the queue state from the
+     * segment headers left by a previous run.
+     */
+    bool begin(IOfflineStorage& storage) {
+        _storage = &storage;
+        _staged = 0; _stagedAt = 0;
+        _dropped = 0; _pending = 0;
+        uint32_t minGen = 0, maxGen = 0;
+        _readSeg = 0; _writeSeg = 0;
+
+        for (uint8_t i = 0; i < SEGMENTS; i++) {
+            _gen[i]  = 0;
+            _size[i] = storage.size(i);
+            uint8_t hdr[HEADER_SIZE];
+            if (_size[i] < HEADER_SIZE
+                || storage.read(i, 0, hdr, HEADER_SIZE) != HEADER_SIZE
+                || memcmp(hdr, "IIOL", 4) != 0) {
+                _size[i] = 0;
+                continue;
+            }
+            _gen[i] = readU32LE(hdr + 4);
+            if (_size[i] == HEADER_SIZE) { _gen[i] = 0; _size[i] = 0; continue; }
+            if (minGen == 0 || _gen[i] < minGen) { minGen = _gen[i]; _readSeg = i; }
+            if (_gen[i] > maxGen) { maxGen = _gen[i]; _writeSeg = i; }
+        }
+        _nextGen = maxGen + 1;
+        _readOff = HEADER_SIZE;
+        _flashRecords = (maxGen != 0);
+        return true;
+    }
+
+    bool attached() const { return _storage != nullptr; }
+
+    /** True when nothing is waiting (flash and RAM staging). */
+    bool empty() const { return !_flashRecords && _staged == 0; }
+
+    /** Frames appended since boot and not drained yet (RAM estimate). */
+    uint32_t pending() const { return _pending; }
+
+    /** Frames lost because the log was full (oldest segment dropped). */
+    uint32_t dropped() const { return _dropped; }
+
+    /** Appends an encoded frame. */
+    bool append(const uint8_t* frame, uint16_t len) {
+        if (!_storage) return false;
+        size_t rec = RECORD_HDR + len;
+        if (rec > sizeof(_stage) || HEADER_SIZE + rec > INSTANTIOT_OFFLINE_SEGMENT_SIZE) return false;
+        if (_staged + rec > sizeof(_stage)) flush();
+
+        if (_staged == 0) _stagedAt = millis();
+        writeU16LE(_stage + _staged, len);
+        _stage[_staged + 2] = crc8(frame, len);
+        memcpy(_stage + _staged + RECORD_HDR, frame, len);
+        _staged += rec;
+        _pending++;
+        return true;
+    }
+
+    /** Writes the RAM staging to flash. Called by `tick()` and when full. */
+    void flush() {
+        if (!_storage || _staged == 0) return;
+
+        // Start a new segment if the current one cannot take the batch
+        if (_gen[_writeSeg] == 0 || _size[_writeSeg] + _staged > INSTANTIOT_OFFLINE_SEGMENT_SIZE) {
+            uint8_t next = (_gen[_writeSeg] == 0) ? _writeSeg : (uint8_t)((_writeSeg + 1) % SEGMENTS);
+            if (_gen[next] != 0) dropSegment(next);   // full circle: lose the oldest
+            startSegment(next);
+        }
+
+        if (_storage->append(_writeSeg, _stage, _staged)) {
+            _size[_writeSeg] += _staged;
+            _flashRecords = true;
+        } else {
+            IIOT_LOG("[Offline] Flash append FAILED");
+            _dropped += countRecords(_stage, _staged);
+        }
+        _staged = 0;
+    }
+
+    /** Periodic flush of the staging buffer. */
+    void tick() {
+        if (_staged && (uint32_t)(millis() - _stagedAt) >= INSTANTIOT_OFFLINE_FLUSH_MS) flush();
+    }
+
+    /** ms until `tick()` flushes the staging, UINT32_MAX if it is empty. */
+    uint32_t flushDueInMs() const {
+        if (_staged == 0) return UINT32_MAX;
+        uint32_t age = millis() - _stagedAt;
+        return age >= INSTANTIOT_OFFLINE_FLUSH_MS ? 0 : INSTANTIOT_OFFLINE_FLUSH_MS - age;
+    }
+
+    /**
+     * Copies the oldest frame into `buf` without removing it.
+     * @return frame length, 0 if the log is empty
+     */
+    size_t peek(uint8_t* buf, size_t cap) {
+        while (_flashRecords) {
+            uint8_t hdr[RECORD_HDR];
+            if (_readOff + RECORD_HDR > _size[_readSeg]
+                || _storage->read(_readSeg, _readOff, hdr, RECORD_HDR) != RECORD_HDR) {
+                advanceReadSegment();   // end of segment
+                continue;
+            }
+            uint16_t len = readU16LE(hdr);
+            if (_readOff + RECORD_HDR + len > _size[_readSeg]) {
+                advanceReadSegment();   // torn record: ends the segment
+                continue;
+            }
+            if (len > cap
+                || _storage->read(_readSeg, _readOff + RECORD_HDR, buf, len) != len
+                || crc8(buf, len) != hdr[2]) {
+                _readOff += RECORD_HDR + len;   // unreadable record: skip it
+                _dropped++;
+                continue;
+            }
+            _peekLen = RECORD_HDR + len;
+            return len;
+        }
+
+        while (_staged >= RECORD_HDR) {
+            uint16_t len = readU16LE(_stage);
+            if (len > cap) { popStaged(RECORD_HDR + len); _dropped++; continue; }
+            memcpy(buf, _stage + RECORD_HDR, len);
+            _peekLen = RECORD_HDR + len;
+            return len;
+        }
+        return 0;
+    }
+
+    /** Removes the frame returned by the last `peek()`. */
+    void pop() {
+        if (_peekLen == 0) return;
+        if (_flashRecords) {
+            _readOff += _peekLen;
+            if (_readOff >= _size[_readSeg]) advanceReadSegment();
+        } else {
+            popStaged(_peekLen);
+        }
+        _peekLen = 0;
+        if (_pending) _pending--;
+    }
+
+private:
+    IOfflineStorage* _storage = nullptr;
+
+    uint32_t _gen[INSTANTIOT_OFFLINE_SEGMENTS];    // 0 = empty segment
+    size_t   _size[INSTANTIOT_OFFLINE_SEGMENTS];
+    uint32_t _nextGen = 1;
+    uint8_t  _readSeg = 0;
+    uint8_t  _writeSeg = 0;
+    size_t   _readOff = HEADER_SIZE;
+    bool     _flashRecords = false;
+    size_t   _peekLen = 0;
+
+    uint8_t  _stage[INSTANTIOT_OFFLINE_STAGING];
+    size_t   _staged = 0;
+    uint32_t _stagedAt = 0;
+
+    uint32_t _pending = 0;
+    uint32_t _dropped = 0;
+
+    void startSegment(uint8_t seg) {
+        uint8_t hdr[HEADER_SIZE];
+        memcpy(hdr, "IIOL", 4);
+        writeU32LE(hdr + 4, _nextGen);
+        _storage->erase(seg);
+        _storage->append(seg, hdr, HEADER_SIZE);
+        _gen[seg]  = _nextGen++;
+        _size[seg] = HEADER_SIZE;
+        if (!_flashRecords) { _readSeg = seg; _readOff = HEADER_SIZE; }
+        _writeSeg = seg;
+    }
+
+    // Called when the circle is full: `seg` is the oldest segment
+    void dropSegment(uint8_t seg) {
+        IIOT_LOG_VAL("[Offline] Log full, dropping segment ", seg);
+        size_t off = (seg == _readSeg) ? _readOff : HEADER_SIZE;
+        uint8_t hdr[RECORD_HDR];
+        while (off + RECORD_HDR <= _size[seg] && _storage->read(seg, off, hdr, RECORD_HDR) == RECORD_HDR) {
+            off += RECORD_HDR + readU16LE(hdr);
+            _dropped++;
+            if (_pending) _pending--;
+        }
+        _storage->erase(seg);
+        _gen[seg] = 0; _size[seg] = 0;
+        if (seg == _readSeg) {
+            _readSeg = (uint8_t)((seg + 1) % SEGMENTS);
+            _readOff = HEADER_SIZE;
+        }
+    }
+
+    // The read segment is exhausted: release it, continue with the next
+    // one in the circle (segments are always filled round-robin)
+    void advanceReadSegment() {
+        _peekLen = 0;
+        _storage->erase(_readSeg);
+        _gen[_readSeg] = 0; _size[_readSeg] = 0;
+        _readOff = HEADER_SIZE;
+
+        if (_readSeg == _writeSeg) {
+            _flashRecords = false;   // fully drained, restarted by next flush()
+            return;
+        }
+        do {
+            _readSeg = (uint8_t)((_readSeg + 1) % SEGMENTS);
+        } while (_gen[_readSeg] == 0 && _readSeg != _writeSeg);
+        if (_gen[_readSeg] == 0) _flashRecords = false;
+    }
+
+    void popStaged(size_t n) {
+        if (n > _staged) n = _staged;
+        memmove(_stage, _stage + n, _staged - n);
+        _staged -= n;
+    }
+
+    static uint32_t countRecords(const uint8_t* p, size_t n) {
+        uint32_t c = 0;
+        for (size_t off = 0; off + RECORD_HDR <= n; off += RECORD_HDR + readU16LE(p + off)) c++;
+        return c;
+    }
+};
+
+} // namespace InstantIoT
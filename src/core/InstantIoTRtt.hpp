@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * ============================================================
+ * 🏓 InstantIoTRtt.hpp — Rolling round-trip time statistics
+ * ============================================================
+ *
+ * Keeps the last INSTANTIOT_RTT_WINDOW RTT samples (µs) of the current
+ * connection. `snapshot()` computes min / avg / p99 / max over the
+ * window (sorts a copy: cost paid by the reader, not by the sampler).
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include "../InstantIoTConfig.h"
+
+namespace InstantIoT {
+
+struct RttStats {
+    uint32_t samples;    // samples in the window
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t p99Us;
+    uint32_t maxUs;
+    uint32_t lastUs;
+    uint32_t sent;       // pings sent on this connection
+    uint32_t lost;       // pings never answered
+};
+
+class RttWindow {
+public:
+    void reset() {
+        _count = 0; _next = 0;
+        _sent = 0; _lost = 0; _last = 0;
+    }
+
+    void add(uint32_t rttUs) {
+        _win[_next] = rttUs;
+        _next = (_next + 1) % INSTANTIOT_RTT_WINDOW;
+        if (_count < INSTANTIOT_RTT_WINDOW) _count++;
+        _last = rttUs;
+    }
+
+    void countSent() { _sent++; }
+    void countLost() { _lost++; }
+
+    RttStats snapshot() const {
+        RttStats s;
+        memset(&s, 0, sizeof(s));
+        s.samples = _count;
+        s.sent    = _sent;
+        s.lost    = _lost;
+        s.lastUs  = _last;
+        if (_count == 0) return s;
+
+        uint32_t sorted[INSTANTIOT_RTT_WINDOW];
+        uint64_t sum = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            // insertion sort — window is small
+            uint32_t v = _win[i];
+            uint8_t j = i;
+            while (j > 0 && sorted[j - 1] > v) { sorted[j] = sorted[j - 1]; j--; }
+            sorted[j] = v;
+            sum += v;
+        }
+        s.minUs = sorted[0];
+        s.maxUs = sorted[_count - 1];
+        s.avgUs = (uint32_t)(sum / _count);
+        // nearest-rank p99
+        uint32_t rank = (99u * _count + 99u) / 100u;
+        s.p99Us = sorted[rank > 0 ? rank - 1 : 0];
+        return s;
+    }
+
+private:
+    uint32_t _win[INSTANTIOT_RTT_WINDOW];
+    uint8_t  _count = 0;
+    uint8_t  _next  = 0;
+    uint32_t _sent  = 0;
+    uint32_t _lost  = 0;
+    uint32_t _last  = 0;
+};
+
+} // namespace InstantIoT
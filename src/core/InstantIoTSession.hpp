@@ -0,0 +1,142 @@
+#pragma once
+/**
+ * ============================================================
+ * 🔁 InstantIoTSession.hpp — Replay ring for acked server sessions
+ * ============================================================
+ *
+ * Bounded byte ring holding the most recent encoded frames of the
+ * session, each tagged with an implicit sequence number (frames are
+ * numbered in push order, starting at 0 for the session).
+ *
+ * Record layout inside the ring: [LEN(2B LE) | FRAME_BYTES]
+ * Records may wrap around the end of the storage.
+ *
+ * Lifecycle:
+ *   push()     → a data frame enters the ring, gets seq = nextSeq()
+ *   ackUpTo(n) → the server confirmed frames [0, n) — released
+ *   forEachFrom(seq, fn) → replays frames ≥ seq in order
+ *
+ * When the ring is full, the oldest frames are evicted (and counted in
+ * `evicted()`): a replay can then only restart from `oldestSeq()`.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "../InstantIoTConfig.h"
+
+namespace InstantIoT {
+
+template<size_t CAPACITY>
+class FrameRing {
+public:
+
+    FrameRing() { clear(0); }
+
+    /** Resets the ring, next pushed frame gets `firstSeq`. */
+    void clear(uint32_t firstSeq) {
+        _head = 0; _tail = 0; _used = 0;
+        _count = 0;
+        _oldestSeq = firstSeq;
+        _evicted = 0;
+    }
+
+    /**
+     * Appends a frame. Evicts the oldest ones if needed.
+     * @param outSeq receives the seq assigned to the frame
+     * @return false if the frame is larger than the whole ring (not stored)
+     */
+    bool push(const uint8_t* frame, uint16_t len, uint32_t& outSeq) {
+        size_t need = 2 + (size_t)len;
+        if (need > CAPACITY) return false;
+        while (CAPACITY - _used < need) { dropOldest(); _evicted++; }
+
+        uint8_t hdr[2] = { (uint8_t)(len & 0xFF), (uint8_t)(len >> 8) };
+        copyIn(hdr, 2);
+        copyIn(frame, len);
+        outSeq = _oldestSeq + _count;
+        _count++;
+        return true;
+    }
+
+    /** Releases every frame whose seq is < `seq` (cumulative ack). */
+    void ackUpTo(uint32_t seq) {
+        while (_count > 0 && (int32_t)(seq - _oldestSeq) > 0) dropOldest();
+        // Everything acked — keep numbering continuous
+        if (_count == 0 && (int32_t)(seq - _oldestSeq) > 0) _oldestSeq = seq;
+    }
+
+    /**
+     * Calls `fn(ctx, frame, len)` for every stored frame with seq ≥ `seq`,
+     * in order. Stops early if `fn` returns false.
+     * @return number of frames handed to `fn`
+     */
+    uint32_t forEachFrom(
+        uint32_t seq,
+        bool (*fn)(void* ctx, const uint8_t* frame, uint16_t len),
+        void* ctx
+    ) const {
+        uint8_t tmp[INSTANT_TX_BUFFER_SIZE];
+        size_t pos = _head;
+        uint32_t s = _oldestSeq, n = 0;
+        for (uint32_t i = 0; i < _count; i++, s++) {
+            uint8_t hdr[2];
+            copyOut(pos, hdr, 2);
+            uint16_t len = (uint16_t)hdr[0] | ((uint16_t)hdr[1] << 8);
+            size_t body = (pos + 2) % CAPACITY;
+            pos = (body + len) % CAPACITY;
+            if ((int32_t)(s - seq) < 0) continue;
+            if (len > sizeof(tmp)) continue;
+            copyOut(body, tmp, len);
+            n++;
+            if (!fn(ctx, tmp, len)) break;
+        }
+        return n;
+    }
+
+    uint32_t oldestSeq() const { return _oldestSeq; }
+    uint32_t nextSeq()   const { return _oldestSeq + _count; }
+    uint32_t count()     const { return _count; }
+    uint32_t evicted()   const { return _evicted; }
+    size_t   bytesUsed() const { return _used; }
+
+private:
+    uint8_t  _buf[CAPACITY];
+    size_t   _head;       // read position (oldest record)
+    size_t   _tail;       // write position
+    size_t   _used;
+    uint32_t _count;
+    uint32_t _oldestSeq;
+    uint32_t _evicted;
+
+    void dropOldest() {
+        if (_count == 0) return;
+        uint8_t hdr[2];
+        copyOut(_head, hdr, 2);
+        uint16_t len = (uint16_t)hdr[0] | ((uint16_t)hdr[1] << 8);
+        _head = (_head + 2 + len) % CAPACITY;
+        _used -= 2 + (size_t)len;
+        _count--;
+        _oldestSeq++;
+    }
+
+    void copyIn(const uint8_t* src, size_t n) {
+        size_t first = CAPACITY - _tail;
+        if (first > n) first = n;
+        memcpy(_buf + _tail, src, first);
+        if (n > first) memcpy(_buf, src + first, n - first);
+        _tail = (_tail + n) % CAPACITY;
+        _used += n;
+    }
+
+    void copyOut(size_t pos, uint8_t* dst, size_t n) const {
+        size_t first = CAPACITY - pos;
+        if (first > n) first = n;
+        memcpy(dst, _buf + pos, first);
+        if (n > first) memcpy(dst + first, _buf, n - first);
+    }
+};
+
+} // namespace InstantIoT
@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * ============================================================
+ * 🔁 InstantIoTSpscRing.hpp — Bounded single-producer / single-consumer ring
+ * ============================================================
+ *
+ * Fixed array of N slots (power of 2), filled and drained in place:
+ *
+ *   T* slot = ring.beginPush();      // nullptr when full
+ *   if (slot) { fill(*slot); ring.endPush(); }
+ *
+ *   T* next = ring.front();          // nullptr when empty
+ *   if (next) { use(*next); ring.pop(); }
+ *
+ * One context may push and another one pop at the same time (two
+ * FreeRTOS tasks, or the loop and an ISR) without a lock: each index
+ * is written by one side only, published with release / read with
+ * acquire ordering. Two producers (or two consumers) need their own
+ * lock. On AVR the indices are 8-bit, so plain volatile accesses are
+ * already atomic.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace InstantIoT {
+
+#if defined(__AVR__)
+typedef uint8_t SpscIndex;
+#define IIOT_SPSC_LOAD(v)      (v)
+#define IIOT_SPSC_STORE(v, x)  ((v) = (x))
+#else
+typedef uint16_t SpscIndex;
+#define IIOT_SPSC_LOAD(v)      __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define IIOT_SPSC_STORE(v, x)  __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#endif
+
+template<typename T, size_t N>
+class SpscRing {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing: N must be a power of 2");
+    static_assert(N <= ((SpscIndex)~(SpscIndex)0 >> 1) + 1, "SpscRing: N too large for the index type");
+
+    // ─── Producer side ───────────────────────────────────────
+
+    /** Free slot to fill, or nullptr if the ring is full. */
+    T* beginPush() {
+        const SpscIndex head = _head;
+        if ((SpscIndex)(head - IIOT_SPSC_LOAD(_tail)) >= N) return nullptr;
+        return &_slots[head & (N - 1)];
+    }
+
+    /** Publishes the slot returned by beginPush(). */
+    void endPush() { IIOT_SPSC_STORE(_head, (SpscIndex)(_head + 1)); }
+    void endPush(T*) { endPush(); }     // same call shape as MpscRing
+
+    bool push(const T& v) {
+        T* slot = beginPush();
+        if (!slot) return false;
+        *slot = v;
+        endPush();
+        return true;
+    }
+
+    // ─── Consumer side ───────────────────────────────────────
+
+    /** Oldest published slot, or nullptr if the ring is empty. */
+    T* front() {
+        const SpscIndex tail = _tail;
+        if (tail == IIOT_SPSC_LOAD(_head)) return nullptr;
+        return &_slots[tail & (N - 1)];
+    }
+
+    /** Releases the slot returned by front(). */
+    void pop() { IIOT_SPSC_STORE(_tail, (SpscIndex)(_tail + 1)); }
+
+    // ─── Either side (a snapshot, may be stale) ──────────────
+
+    size_t size() const {
+        return (SpscIndex)(IIOT_SPSC_LOAD(_head) - IIOT_SPSC_LOAD(_tail));
+    }
+    bool empty() const { return size() == 0; }
+    bool full()  const { return size() >= N; }
+    static size_t capacity() { return N; }
+
+private:
+    T                  _slots[N];
+    volatile SpscIndex _head = 0;   // written by the producer only
+    volatile SpscIndex _tail = 0;   // written by the consumer only
+};
+
+} // namespace InstantIoT
@@ -0,0 +1,137 @@
+#pragma once
+/**
+ * ============================================================
+ * 🧵 InstantIoTTrace.hpp — Binary trace ring for post-mortem debugging
+ * ============================================================
+ *
+ * Fixed RAM ring of INSTANTIOT_TRACE_RECORDS 8-byte records, appended
+ * by IIOT_TRACE(event, a, b): one micros() read, one 8-byte store, one
+ * masked increment — no formatting, no I/O, so enabling it does not
+ * change the timing being debugged. The oldest records are overwritten.
+ *
+ * Record (little-endian):  [US u32 | EVENT u8 | A u8 | B u16]
+ *
+ * Dump formats (decoded by extras/iiot_trace.py):
+ *   - stream (Serial):  "IIOTTRC1" | COUNT u16 | RECORD × COUNT
+ *   - frames (transport): TYPE_TRACE / EV_TRACE_CHUNK, payload
+ *       [CHUNK u16 | CHUNKS u16 | RECORD × n]
+ * Records are always dumped oldest first.
+ *
+ * Appends may come from any task or ISR: each one claims its slot with
+ * an atomic increment (with the network task, RX / TX records and the
+ * sketch's DISPATCH records are appended from both cores).
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "../InstantIoTConfig.h"
+
+namespace InstantIoT {
+
+// Event codes — A / B meaning per event
+enum TraceEvent : uint8_t {
+    TRACE_RX_FRAME     = 0x01,  // A = type      B = frame length
+    TRACE_TX_FRAME     = 0x02,  // A = type      B = frame length
+    TRACE_TX_SHORT     = 0x03,  // A = type      B = bytes accepted
+    TRACE_DISPATCH     = 0x04,  // A = type      B = event code
+    TRACE_DISPATCH_END = 0x05,  // A = type      B = duration µs (sat. 65535)
+    TRACE_DECODE_ERROR = 0x06,  // A = 0         B = frame length
+    TRACE_CRC_ERROR    = 0x07,  // A = 0         B = body length
+    TRACE_RX_OVERFLOW  = 0x08,  // A = 0         B = bytes dropped
+    TRACE_RESYNC       = 0x09,  // A = 0         B = bytes skipped
+    TRACE_CONNECT      = 0x0A,
+    TRACE_DISCONNECT   = 0x0B,
+    TRACE_RECONNECT    = 0x0C,  // A = 0 WiFi / 1 TCP   B = attempt
+    TRACE_RECONNECT_KO = 0x0D,  // A = 0 WiFi / 1 TCP   B = attempt
+    TRACE_COALESCED    = 0x0E,  // A = 0         B = frame length
+    TRACE_USER         = 0x80   // 0x80..0xFF free for sketches
+};
+
+struct TraceRecord {
+    uint32_t us;
+    uint8_t  event;
+    uint8_t  a;
+    uint16_t b;
+};
+
+static_assert(sizeof(TraceRecord) == 8, "TraceRecord must stay 8 bytes");
+
+class TraceRing {
+public:
+    static const uint16_t CAPACITY = INSTANTIOT_TRACE_RECORDS;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "INSTANTIOT_TRACE_RECORDS must be a power of 2");
+    static const uint8_t  RECORD_SIZE = 8;
+
+    void add(uint8_t event, uint8_t a, uint16_t b) {
+        if (_paused) return;
+        TraceRecord& r = _rec[claim() & (CAPACITY - 1)];
+        r.us    = micros();
+        r.event = event;
+        r.a     = a;
+        r.b     = b;
+    }
+
+    void clear() { _next = 0; }
+
+    /** Records held (≤ CAPACITY). */
+    uint16_t count() const { return _next < CAPACITY ? (uint16_t)_next : CAPACITY; }
+
+    /** Stops / resumes recording (dumps pause it so they do not trace themselves). */
+    void pause(bool p) { _paused = p; }
+
+    /** `i`-th held record, 0 = oldest. Serialized in `out[8]`. */
+    void read(uint16_t i, uint8_t* out) const {
+        const TraceRecord& r = _rec[(_next - count() + i) & (CAPACITY - 1)];
+        out[0] = (uint8_t)(r.us);       out[1] = (uint8_t)(r.us >> 8);
+        out[2] = (uint8_t)(r.us >> 16); out[3] = (uint8_t)(r.us >> 24);
+        out[4] = r.event;
+        out[5] = r.a;
+        out[6] = (uint8_t)(r.b);        out[7] = (uint8_t)(r.b >> 8);
+    }
+
+    /** Writes the stream format to `out` (e.g. Serial). */
+    void dump(Print& out) {
+        pause(true);
+        const uint16_t n = count();
+        const uint8_t hdr[10] = { 'I','I','O','T','T','R','C','1',
+                                  (uint8_t)(n & 0xFF), (uint8_t)(n >> 8) };
+        out.write(hdr, sizeof(hdr));
+        uint8_t rec[RECORD_SIZE];
+        for (uint16_t i = 0; i < n; i++) {
+            read(i, rec);
+            out.write(rec, sizeof(rec));
+        }
+        pause(false);
+    }
+
+private:
+    // Index of a fresh record: concurrent appends never share a slot
+    uint32_t claim() {
+        #if defined(__AVR__)
+        const uint8_t sreg = SREG;
+        cli();
+        const uint32_t i = _next++;
+        SREG = sreg;
+        return i;
+        #else
+        return __atomic_fetch_add(&_next, 1, __ATOMIC_RELAXED);
+        #endif
+    }
+
+    TraceRecord _rec[CAPACITY];
+    volatile uint32_t _next   = 0;   // total appends (index = _next & mask)
+    bool              _paused = false;
+};
+
+/** The process-wide ring (shared by the core, the codec and transports). */
+inline TraceRing& traceRing() {
+    static TraceRing ring;
+    return ring;
+}
+
+} // namespace InstantIoT
+
+#define IIOT_TRACE(event, a, b) ::InstantIoT::traceRing().add((uint8_t)(event), (uint8_t)(a), (uint16_t)(b))
@@ -0,0 +1,42 @@
+#pragma once
+/**
+ * ============================================================
+ * 📤 InstantIoTTxQueue.hpp — Encoded frames waiting for the I/O context
+ * ============================================================
+ *
+ * sendBinary() called outside the context that owns the transport (the
+ * network task, or with INSTANTIOT_TX_MPSC another task / an ISR)
+ * encodes straight into a TxFrame slot; the owner writes the queued
+ * frames from ioStep(). Slots are fixed-size, no heap.
+ *
+ * With INSTANTIOT_TX_MPSC the queue accepts any number of producers
+ * (MpscRing), otherwise exactly one (SpscRing, the sketch's task).
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include "../InstantIoTConfig.h"
+#include "InstantIoTSpscRing.hpp"
+#include "InstantIoTMpscRing.hpp"
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace InstantIoT {
+
+struct TxFrame {
+    uint16_t len;       // 0: claimed but nothing to send (encode failed)
+    uint8_t  typeCode;
+    uint8_t  bytes[INSTANT_TX_BUFFER_SIZE];
+};
+
+#if INSTANTIOT_TX_MPSC
+typedef MpscRing<TxFrame, INSTANTIOT_TX_QUEUE_SIZE> TxQueue;
+#else
+typedef SpscRing<TxFrame, INSTANTIOT_TX_QUEUE_SIZE> TxQueue;
+#endif
+
+} // namespace InstantIoT
@@ -30,8 +30,22 @@ public:
         size_t payloadLen = 0
     ) = 0;
 
+    /**
+     * Largest payload that still fits one frame for this widget
+     * (TX buffer minus header, ids and CRC). 0 = unknown.
+     */
+    virtual size_t maxPayloadLen(const char* widgetId) { (void)widgetId; return 0; }
+
     /**
      * @return true if a client is connected
      */
     virtual bool connected() = 0;
+
+    /**
+     * Converts a local `millis()` value to server time (epoch ms)
+     *
+     * @param localMs  Local timestamp (millis())
+     * @return server time in ms, 0 if the clock is not synchronized
+     */
+    virtual uint64_t serverTimeMs(uint32_t localMs) { (void)localMs; return 0; }
 };
\ No newline at end of file
@@ -28,14 +28,101 @@
 //
 // RAM: 12 B per block (ESP32, 3 ptrs × 4 B). No heap.
 // Dispatch cost: 1 strcmp per registered handler of the relevant type.
+//
+// With INSTANTIOT_HANDLER_PROFILING, every block and every legacy
+// on*Event callback also records its execution time (micros()):
+// +24 B per block. See WidgetRegistry::dumpProfiles().
 // ============================================================
 namespace InstantIoT {
 
+#if INSTANTIOT_HANDLER_PROFILING
+// ============================================================
+// ⏱️ HANDLER PROFILING
+// ============================================================
+
+struct HandlerProfile {
+    uint32_t calls;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+struct HandlerProfileInfo {
+    const char*           kind;      // widget kind, e.g. "Joystick"
+    const char*           widgetId;  // nullptr for a legacy callback
+    bool                  legacy;    // on*Event callback
+    HandlerProfile*       profile;
+};
+
+// Called after any handler that ran for at least the threshold
+typedef void (*SlowHandlerHook)(const HandlerProfileInfo& info, uint32_t us);
+
+struct SlowHandlerConfig {
+    SlowHandlerHook hook;
+    uint32_t        thresholdUs;
+};
+
+inline SlowHandlerConfig& slowHandlerConfig() {
+    static SlowHandlerConfig cfg = { nullptr, 0 };
+    return cfg;
+}
+
+template<typename EventT> struct HandlerKind;
+#define IIOT_HANDLER_KIND(EventT, idx, name) \
+    template<> struct HandlerKind<EventT> { \
+        static const uint8_t index = idx; \
+        static const char* label() { return name; } \
+    };
+IIOT_HANDLER_KIND(SimpleButtonEvent,     0, "SimpleButton")
+IIOT_HANDLER_KIND(AdvancedButtonEvent,   1, "AdvancedButton")
+IIOT_HANDLER_KIND(EmergencyButtonEvent,  2, "EmergencyButton")
+IIOT_HANDLER_KIND(HorizontalSliderEvent, 3, "HorizontalSlider")
+IIOT_HANDLER_KIND(VerticalSliderEvent,   4, "VerticalSlider")
+IIOT_HANDLER_KIND(SwitchEvent,           5, "Switch")
+IIOT_HANDLER_KIND(JoystickEvent,         6, "Joystick")
+IIOT_HANDLER_KIND(DirectionPadEvent,     7, "DirectionPad")
+IIOT_HANDLER_KIND(SegmentedSwitchEvent,  8, "SegmentedSwitch")
+#undef IIOT_HANDLER_KIND
+static const uint8_t HANDLER_KIND_COUNT = 9;
+
+// Legacy on*Event callbacks, indexed by HandlerKind<EventT>::index
+inline HandlerProfile* legacyProfiles() {
+    static HandlerProfile profiles[HANDLER_KIND_COUNT];
+    return profiles;
+}
+
+template<typename EventT>
+inline void runProfiled(
+    HandlerProfile& p,
+    const char* widgetId,
+    bool legacy,
+    void (*fn)(const EventT&),
+    const EventT& e
+) {
+    uint32_t t0 = micros();
+    fn(e);
+    uint32_t us = micros() - t0;
+    p.calls++;
+    p.lastUs   = us;
+    p.totalUs += us;
+    if (us > p.maxUs) p.maxUs = us;
+
+    const SlowHandlerConfig& cfg = slowHandlerConfig();
+    if (cfg.hook && us >= cfg.thresholdUs) {
+        HandlerProfileInfo info = { HandlerKind<EventT>::label(), widgetId, legacy, &p };
+        cfg.hook(info, us);
+    }
+}
+#endif
+
 template<typename EventT>
 struct WidgetHandler {
     const char* widgetId;
     void (*fn)(const EventT&);
     WidgetHandler<EventT>* next;
+    #if INSTANTIOT_HANDLER_PROFILING
+    HandlerProfile profile;
+    #endif
 };
 
 template<typename EventT>
@@ -51,6 +138,9 @@ struct WidgetRegistrar {
         node.widgetId = id;
         node.fn       = fn;
         node.next     = handlerListHead<EventT>();
+        #if INSTANTIOT_HANDLER_PROFILING
+        node.profile  = HandlerProfile();
+        #endif
         handlerListHead<EventT>() = &node;
     }
 };
@@ -59,11 +149,26 @@ template<typename EventT>
 inline void dispatchToHandlers(const EventT& e) {
     for (auto* h = handlerListHead<EventT>(); h; h = h->next) {
         if (h->widgetId && e.widgetId && strcmp(h->widgetId, e.widgetId) == 0) {
+            #if INSTANTIOT_HANDLER_PROFILING
+            runProfiled(h->profile, h->widgetId, false, h->fn, e);
+            #else
             h->fn(e);
+            #endif
         }
     }
 }
 
+/** Legacy callback first, then the per-widget handlers. */
+template<typename EventT>
+inline void deliverEvent(const EventT& e, void (*legacy)(const EventT&)) {
+    #if INSTANTIOT_HANDLER_PROFILING
+    runProfiled(legacyProfiles()[HandlerKind<EventT>::index], (const char*)nullptr, true, legacy, e);
+    #else
+    legacy(e);
+    #endif
+    dispatchToHandlers(e);
+}
+
 } // namespace InstantIoT
 
 // ============================================================
@@ -84,19 +189,36 @@ namespace InstantIoT {
 
 class WidgetRegistry {
 public:
+    /** Decodes then delivers one widget event (see decode / deliver). */
     static void dispatch(
         uint8_t typeCode,
         const char* widgetId,
         uint8_t eventCode,
         const DecodedMessage& msg
     ) {
-        if (!widgetId) return;
+        AnyEvent e;
+        if (decode(typeCode, widgetId, eventCode, msg, e)) deliver(e);
+    }
+
+    /**
+     * Builds the typed event of a frame without running any handler.
+     * @return false for an unknown type / event code
+     */
+    static bool decode(
+        uint8_t typeCode,
+        const char* widgetId,
+        uint8_t eventCode,
+        const DecodedMessage& msg,
+        AnyEvent& out
+    ) {
+        out.kind = AnyEvent::None;
+        if (!widgetId) return false;
 
         switch (typeCode) {
 
             // ── SimpleButton ──────────────────────────────────
             case TYPE_SIMPLEBUTTON: {
-                SimpleButtonEvent e;
+                SimpleButtonEvent& e = out.simpleButton;
                 e.widgetId = widgetId;
                 e.isOn     = msg.getParamBool("state", false);
                 switch (eventCode) {
@@ -104,16 +226,15 @@ public:
                     case CMD_RELEASE:        e.kind = ButtonEventKind::Release;   break;
                     case CMD_LONGPRESS:      e.kind = ButtonEventKind::LongPress; break;
                     case CMD_TOGGLE:         e.kind = ButtonEventKind::Toggle;    break;
-                    default: return;
+                    default: return false;
                 }
-                onSimpleButtonEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::SimpleButton;
+                return true;
             }
 
             // ── AdvancedButton ────────────────────────────────
             case TYPE_ADVANCEDBUTTON: {
-                AdvancedButtonEvent e;
+                AdvancedButtonEvent& e = out.advancedButton;
                 e.widgetId = widgetId;
                 e.isOn     = msg.getParamBool("state", false);
                 switch (eventCode) {
@@ -121,16 +242,15 @@ public:
                     case CMD_RELEASE:   e.kind = ButtonEventKind::Release;   break;
                     case CMD_LONGPRESS: e.kind = ButtonEventKind::LongPress; break;
                     case CMD_TOGGLE:    e.kind = ButtonEventKind::Toggle;    break;
-                    default: return;
+                    default: return false;
                 }
-                onAdvancedButtonEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::AdvancedButton;
+                return true;
             }
 
             // ── HorizontalSlider ──────────────────────────────
             case TYPE_HSLIDER: {
-                HorizontalSliderEvent e;
+                HorizontalSliderEvent& e = out.horizontalSlider;
                 e.widgetId = widgetId;
                 e.value    = msg.getParamFloat("value", 0.0f);
                 switch (eventCode) {
@@ -138,16 +258,15 @@ public:
                     case CMD_VALUECHANGED:  e.kind = SliderEventKind::ValueChanged;  break;
                     case CMD_DRAGSTARTED:   e.kind = SliderEventKind::DragStarted;   break;
                     case CMD_DRAGENDED:     e.kind = SliderEventKind::DragEnded;     break;
-                    default: return;
+                    default: return false;
                 }
-                onHorizontalSliderEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::HorizontalSlider;
+                return true;
             }
 
             // ── VerticalSlider ────────────────────────────────
             case TYPE_VSLIDER: {
-                VerticalSliderEvent e;
+                VerticalSliderEvent& e = out.verticalSlider;
                 e.widgetId = widgetId;
                 e.value    = msg.getParamFloat("value", 0.0f);
                 switch (eventCode) {
@@ -155,16 +274,15 @@ public:
                     case CMD_VALUECHANGED:  e.kind = SliderEventKind::ValueChanged;  break;
                     case CMD_DRAGSTARTED:   e.kind = SliderEventKind::DragStarted;   break;
                     case CMD_DRAGENDED:     e.kind = SliderEventKind::DragEnded;     break;
-                    default: return;
+                    default: return false;
                 }
-                onVerticalSliderEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::VerticalSlider;
+                return true;
             }
 
             // ── Switch ────────────────────────────────────────
             case TYPE_SWITCH: {
-                SwitchEvent e;
+                SwitchEvent& e = out.switchEvent;
                 e.widgetId = widgetId;
                 switch (eventCode) {
                     case CMD_TURNON:
@@ -183,16 +301,15 @@ public:
                         e.kind = SwitchEventKind::SetValue;
                         e.isOn = msg.getParamBool("value", false);
                         break;
-                    default: return;
+                    default: return false;
                 }
-                onSwitchEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::Switch;
+                return true;
             }
 
             // ── Joystick ──────────────────────────────────────
             case TYPE_JOYSTICK: {
-                JoystickEvent e;
+                JoystickEvent& e = out.joystick;
                 e.widgetId = widgetId;
                 e.x        = msg.getParamFloat("x", 0.0f);
                 e.y        = msg.getParamFloat("y", 0.0f);
@@ -204,16 +321,15 @@ public:
                         e.kind = JoystickEventKind::Released;
                         e.x = 0; e.y = 0;
                         break;
-                    default: return;
+                    default: return false;
                 }
-                onJoystickEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::Joystick;
+                return true;
             }
 
            // ── DirectionPad ──────────────────────────────────
             case TYPE_DIRECTIONPAD: {
-                DirectionPadEvent e;
+                DirectionPadEvent& e = out.directionPad;
                 e.widgetId  = widgetId;
                 e.buttonName = "";
 
@@ -231,16 +347,15 @@ public:
                     case CMD_BTNPRESSED:     e.kind = DPadEventKind::Press;     break;
                     case CMD_BTNRELEASED:    e.kind = DPadEventKind::Release;   break;
                     case CMD_BTNLONGPRESSED: e.kind = DPadEventKind::LongPress; break;
-                    default: return;
+                    default: return false;
                 }
-                onDirectionPadEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::DirectionPad;
+                return true;
             }
 
             // ── SegmentedSwitch ───────────────────────────────
             case TYPE_SEGSWITCH: {
-                SegmentedSwitchEvent e;
+                SegmentedSwitchEvent& e = out.segmentedSwitch;
                 e.widgetId     = widgetId;
                 e.selectedIndex = msg.getParamInt("index", -1);
                 e.selectedIds  = msg.getParam("ids");
@@ -251,32 +366,99 @@ public:
                     case CMD_SELCHANGED:   e.kind = SegmentedEventKind::SelectionChanged;  break;
                     case CMD_SEGSELECTED:  e.kind = SegmentedEventKind::SegmentSelected;   break;
                     case CMD_SEGDESELECTED: e.kind = SegmentedEventKind::SegmentDeselected; break;
-                    default: return;
+                    default: return false;
                 }
-                onSegmentedSwitchEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::SegmentedSwitch;
+                return true;
             }
 
             // ── EmergencyButton ───────────────────────────────
             case TYPE_EMERGENCYBUTTON: {
-                EmergencyButtonEvent e;
+                EmergencyButtonEvent& e = out.emergencyButton;
                 e.widgetId = widgetId;
                 switch (eventCode) {
                     case CMD_EMERGENCY_TRIGGER: e.kind = EmergencyEventKind::Trigger; break;
                     case CMD_EMERGENCY_RESET:   e.kind = EmergencyEventKind::Reset;   break;
-                    default: return;
+                    default: return false;
                 }
-                onEmergencyButtonEvent(e);
-                InstantIoT::dispatchToHandlers(e);
-                return;
+                out.kind = AnyEvent::EmergencyButton;
+                return true;
             }
 
             default:
-                return;
+                return false;
+        }
+    }
+
+    /** Runs the legacy callback, then the I<Widget> blocks of `e`. */
+    static void deliver(const AnyEvent& e) {
+        switch (e.kind) {
+            case AnyEvent::SimpleButton:     InstantIoT::deliverEvent(e.simpleButton,     onSimpleButtonEvent);     return;
+            case AnyEvent::AdvancedButton:   InstantIoT::deliverEvent(e.advancedButton,   onAdvancedButtonEvent);   return;
+            case AnyEvent::EmergencyButton:  InstantIoT::deliverEvent(e.emergencyButton,  onEmergencyButtonEvent);  return;
+            case AnyEvent::HorizontalSlider: InstantIoT::deliverEvent(e.horizontalSlider, onHorizontalSliderEvent); return;
+            case AnyEvent::VerticalSlider:   InstantIoT::deliverEvent(e.verticalSlider,   onVerticalSliderEvent);   return;
+            case AnyEvent::Switch:           InstantIoT::deliverEvent(e.switchEvent,      onSwitchEvent);           return;
+            case AnyEvent::Joystick:         InstantIoT::deliverEvent(e.joystick,         onJoystickEvent);         return;
+            case AnyEvent::DirectionPad:     InstantIoT::deliverEvent(e.directionPad,     onDirectionPadEvent);     return;
+            case AnyEvent::SegmentedSwitch:  InstantIoT::deliverEvent(e.segmentedSwitch,  onSegmentedSwitchEvent);  return;
+            default: return;
+        }
+    }
+
+    #if INSTANTIOT_HANDLER_PROFILING
+    // ════════════════════════════════════════════════════════
+    // ⏱️ Handler profiling
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * Calls `fn` for every legacy callback, then every I<Widget>
+     * block. Legacy callbacks are listed even if the sketch does not
+     * define them (the library's empty default is then measured).
+     */
+    static void forEachProfile(
+        void (*fn)(void* ctx, const HandlerProfileInfo& info),
+        void* ctx
+    ) {
+        HandlerProfile* legacy = legacyProfiles();
+        for (uint8_t k = 0; k < HANDLER_KIND_COUNT; k++) {
+            HandlerProfileInfo info = { kindLabel(k), nullptr, true, &legacy[k] };
+            fn(ctx, info);
         }
+        visitList<SimpleButtonEvent>(fn, ctx);
+        visitList<AdvancedButtonEvent>(fn, ctx);
+        visitList<EmergencyButtonEvent>(fn, ctx);
+        visitList<HorizontalSliderEvent>(fn, ctx);
+        visitList<VerticalSliderEvent>(fn, ctx);
+        visitList<SwitchEvent>(fn, ctx);
+        visitList<JoystickEvent>(fn, ctx);
+        visitList<DirectionPadEvent>(fn, ctx);
+        visitList<SegmentedSwitchEvent>(fn, ctx);
+    }
+
+    /**
+     * Prints one line per handler that ran at least once:
+     *   Joystick "joy1" calls=120 total=5400us max=830us last=41us
+     *   onSwitchEvent calls=3 total=12us max=5us last=3us
+     */
+    static void dumpProfiles(Print& out) {
+        forEachProfile(printProfile, &out);
     }
 
+    static void resetProfiles() {
+        forEachProfile(resetProfile, nullptr);
+    }
+
+    /**
+     * Calls `hook` after every handler that ran ≥ `thresholdUs`
+     * (from the loop() context). `hook = nullptr` disables.
+     */
+    static void setSlowHandlerHook(uint32_t thresholdUs, SlowHandlerHook hook) {
+        slowHandlerConfig().thresholdUs = thresholdUs;
+        slowHandlerConfig().hook        = hook;
+    }
+    #endif
+
     // ════════════════════════════════════════════════════════
     // String overload → kept for compatibility
     // but delegates to the uint8 version
@@ -291,6 +473,46 @@ public:
         // but we keep it so as not to break any legacy usages
         (void)widgetType; (void)widgetId; (void)event; (void)msg;
     }
+
+#if INSTANTIOT_HANDLER_PROFILING
+private:
+    static const char* kindLabel(uint8_t k) {
+        static const char* const labels[HANDLER_KIND_COUNT] = {
+            "SimpleButton", "AdvancedButton", "EmergencyButton",
+            "HorizontalSlider", "VerticalSlider", "Switch",
+            "Joystick", "DirectionPad", "SegmentedSwitch"
+        };
+        return k < HANDLER_KIND_COUNT ? labels[k] : "?";
+    }
+
+    template<typename EventT>
+    static void visitList(void (*fn)(void*, const HandlerProfileInfo&), void* ctx) {
+        for (auto* h = handlerListHead<EventT>(); h; h = h->next) {
+            HandlerProfileInfo info = { HandlerKind<EventT>::label(), h->widgetId, false, &h->profile };
+            fn(ctx, info);
+        }
+    }
+
+    static void printProfile(void* ctx, const HandlerProfileInfo& info) {
+        const HandlerProfile& p = *info.profile;
+        if (p.calls == 0) return;
+        Print& out = *static_cast<Print*>(ctx);
+        if (info.legacy) {
+            out.print("on"); out.print(info.kind); out.print("Event");
+        } else {
+            out.print(info.kind); out.print(" \""); out.print(info.widgetId); out.print("\"");
+        }
+        out.print(" calls=");  out.print((unsigned long)p.calls);
+        out.print(" total=");  out.print((unsigned long)(p.totalUs > 0xFFFFFFFFull ? 0xFFFFFFFFul : p.totalUs));
+        out.print("us max=");  out.print((unsigned long)p.maxUs);
+        out.print("us last="); out.print((unsigned long)p.lastUs);
+        out.println("us");
+    }
+
+    static void resetProfile(void*, const HandlerProfileInfo& info) {
+        *info.profile = HandlerProfile();
+    }
+#endif
 };
 
 } // namespace InstantIoT
\ No newline at end of file
@@ -16,6 +16,17 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
+#include "../InstantIoTConfig.h"
+
+#if INSTANTIOT_LINK_STATS
+/**
+ * Counters only the transport can see (see LinkStats for the rest)
+ */
+struct TransportStats {
+    uint32_t reconnectAttempts;
+    uint32_t reconnectFailures;
+};
+#endif
 
 /**
  * Abstract transport interface
@@ -78,6 +89,29 @@ struct ITransport {
      * @return Number of bytes written
      */
     virtual size_t write(const uint8_t* buf, size_t len) = 0;
+
+    // ============================================================
+    // 💤 IDLE
+    // ============================================================
+
+    /**
+     * Blocks until data is readable or `timeoutMs` elapsed
+     *
+     * @return 1 if data is readable, 0 on timeout,
+     *         -1 if unsupported (the caller delays instead)
+     */
+    virtual int waitForData(uint32_t timeoutMs) {
+        (void)timeoutMs;
+        return -1;
+    }
+
+    /**
+     * @return ms until poll() has work of its own to do (e.g. the next
+     *         reconnect attempt), UINT32_MAX if it only reacts to events
+     */
+    virtual uint32_t pollDueInMs() {
+        return UINT32_MAX;
+    }
     
     // ============================================================
     // 🔧 HELPERS
@@ -93,4 +127,9 @@ struct ITransport {
         n += write(reinterpret_cast<const uint8_t*>("\n"), 1);
         return n;
     }
+
+#if INSTANTIOT_LINK_STATS
+    // Maintained by implementations through IIOT_STAT()
+    TransportStats stats = {};
+#endif
 };
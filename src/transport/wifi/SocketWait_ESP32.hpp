@@ -0,0 +1,47 @@
+#pragma once
+/**
+ * ============================================================
+ * 💤 SocketWait_ESP32.hpp — Wake-on-data wait for WiFiClient sockets
+ * ============================================================
+ *
+ * Shared by the ESP32 TCP transports to implement
+ * ITransport::waitForData(): the calling task blocks in lwIP select()
+ * on the client socket, leaving the CPU to the idle task (and to
+ * automatic light sleep when enabled) until data arrives.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#if !defined(ARDUINO_ARCH_ESP32) && !defined(ESP32)
+#  error "SocketWait_ESP32.hpp requires ESP32"
+#endif
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+namespace InstantIoT {
+
+/**
+ * @return 1 if `client` has readable data, 0 on timeout,
+ *         -1 if there is no usable socket
+ */
+inline int waitSocketReadable(WiFiClient& client, uint32_t timeoutMs) {
+    if (client.available() > 0) return 1;  // already buffered by WiFiClient
+    const int fd = client.fd();
+    if (fd < 0) return -1;
+
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    struct timeval tv;
+    tv.tv_sec  = (long)(timeoutMs / 1000);
+    tv.tv_usec = (long)(timeoutMs % 1000) * 1000;
+
+    const int r = select(fd + 1, &rfds, nullptr, nullptr, &tv);
+    if (r < 0) return -1;
+    return r > 0 ? 1 : 0;
+}
+
+} // namespace InstantIoT
@@ -12,6 +12,7 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "../../core/Transport.h"
+#include "SocketWait_ESP32.hpp"
 #include "../../InstantIoTConfig.h"
 
 #ifndef INSTANT_AP_PORT
@@ -100,6 +101,12 @@ public:
         return client_.write(buf, len);
     }
     
+    // No client yet: accept() is polled, let the caller delay
+    int waitForData(uint32_t timeoutMs) override {
+        if (!connected()) return -1;
+        return waitSocketReadable(client_, timeoutMs);
+    }
+    
     IPAddress getIP() const { return WiFi.softAPIP(); }
     const char* getSSID() const { return ssid_; }
     uint16_t getPort() const { return port_; }
@@ -8,7 +8,8 @@
  * then opens a TCP connection to a remote InstantIoT Server.
  *
  * Handshake: [PAYLOAD_LEN(1B) | PAYLOAD_BYTES]
- *   payload = "token" (legacy) or "token:heartbeatMs" (with heartbeat).
+ *   payload = "token" (legacy) or "token:heartbeatMs" (with heartbeat)
+ *   or "token:heartbeatMs:sessionId" (acked session, sessionId in hex).
  *   Example: "abc-123-def:5000" (heartbeat 5s).
  * Then: standard iWidgets v1 binary frames.
  *
@@ -33,7 +34,11 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "../../core/Transport.h"
+#include "SocketWait_ESP32.hpp"
 #include "../../InstantIoTConfig.h"
+#if INSTANTIOT_TRACE
+#include "../../core/InstantIoTTrace.hpp"
+#endif
 
 #ifndef INSTANTIOT_WIFI_CONNECT_TIMEOUT_MS
   #define INSTANTIOT_WIFI_CONNECT_TIMEOUT_MS 15000
@@ -92,6 +97,20 @@ public:
 
     uint32_t getHeartbeat() const { return heartbeatMs_; }
 
+    // ============================================================
+    // 🔁 Acked session — called by the facade before begin()
+    // ============================================================
+    //
+    // Announces the session id in the handshake so the server can
+    // tell a reconnect (same id → EV_SESSION_RESUME with its frame
+    // count) from a device reboot (new id → count restarts at 0).
+    // `0` = not announced (plain mode).
+    void setSession(uint32_t sessionId) {
+        sessionId_ = sessionId;
+    }
+
+    uint32_t getSession() const { return sessionId_; }
+
     // ============================================================
     // 🔑 WiFi credentials — called by the facade before begin()
     // ============================================================
@@ -124,8 +143,12 @@ public:
             if (millis() < nextRetryAt_) return;
 
             retryAttempt_++;
+            IIOT_STAT(stats.reconnectAttempts++);
+            IIOT_TRACE(TRACE_RECONNECT, 0, retryAttempt_);
             IIOT_LOG_VAL("[WiFiServer] WiFi lost — reconnect attempt #", retryAttempt_);
             if (!connectWiFi()) {
+                IIOT_STAT(stats.reconnectFailures++);
+                IIOT_TRACE(TRACE_RECONNECT_KO, 0, retryAttempt_);
                 scheduleRetry();
                 return;
             }
@@ -140,8 +163,12 @@ public:
             if (millis() < nextRetryAt_) return;
 
             retryAttempt_++;
+            IIOT_STAT(stats.reconnectAttempts++);
+            IIOT_TRACE(TRACE_RECONNECT, 1, retryAttempt_);
             IIOT_LOG_VAL("[WiFiServer] TCP reconnect attempt #", retryAttempt_);
             if (!connectServer()) {
+                IIOT_STAT(stats.reconnectFailures++);
+                IIOT_TRACE(TRACE_RECONNECT_KO, 1, retryAttempt_);
                 scheduleRetry();
                 return;
             }
@@ -181,6 +208,22 @@ public:
         return client_.write(buf, len);
     }
 
+    // ============================================================
+    // 💤 IDLE
+    // ============================================================
+
+    int waitForData(uint32_t timeoutMs) override {
+        if (!connected()) return -1;
+        return waitSocketReadable(client_, timeoutMs);
+    }
+
+    // Disconnected: next reconnect attempt (backoff)
+    uint32_t pollDueInMs() override {
+        if (connected()) return UINT32_MAX;
+        const int32_t d = (int32_t)(nextRetryAt_ - millis());
+        return d > 0 ? (uint32_t)d : 0;
+    }
+
     // ============================================================
     // 🔎 GETTERS
     // ============================================================
@@ -226,6 +269,7 @@ private:
         // Handshake: [PAYLOAD_LEN | PAYLOAD_BYTES]
         //   payload = "token"           (legacy, heartbeatMs_ = 0)
         //   payload = "token:heartbeat"  (heartbeat enabled)
+        //   payload = "token:heartbeat:session" (acked session)
         if (!token_) {
             IIOT_LOG("[WiFiServer] Missing device token");
             client_.stop();
@@ -235,7 +279,11 @@ private:
         // Build the payload (max 255 bytes length-prefixed)
         char payload[288];
         int written = 0;
-        if (heartbeatMs_ > 0) {
+        if (sessionId_ != 0) {
+            written = snprintf(payload, sizeof(payload), "%s:%lu:%08lx",
+                               token_, (unsigned long)heartbeatMs_,
+                               (unsigned long)sessionId_);
+        } else if (heartbeatMs_ > 0) {
             written = snprintf(payload, sizeof(payload), "%s:%lu",
                                token_, (unsigned long)heartbeatMs_);
         } else {
@@ -308,6 +356,7 @@ private:
     uint32_t    backoffMs_;
     uint32_t    retryAttempt_ = 0;  // monotonic counter for debug logs
     uint32_t    heartbeatMs_;       // 0 = legacy, >0 = announced to server
+    uint32_t    sessionId_ = 0;     // 0 = plain mode, else acked session
 };
 
 } // namespace InstantIoT
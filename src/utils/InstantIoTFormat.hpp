@@ -0,0 +1,178 @@
+#pragma once
+/**
+ * ============================================================
+ * 🔤 InstantIoTFormat.hpp - Bounded printf subset, no heap
+ * ============================================================
+ *
+ * Usage:
+ *   char line[48];
+ *   InstantIoT::formatTo(line, sizeof(line), "T=%.1f C  fan %u%%", t, pct);
+ *   instant.text("status").setTextf("%s: %ld ms", name, dt);
+ *
+ * Writes into the caller's buffer only, truncating at `cap - 1` and
+ * always NUL-terminating. Same output on every core, floats included
+ * (AVR's printf has none), and no malloc inside a libc *printf.
+ *
+ * Supported: %d %i %u %x %X %c %s %f %% with flags '-' '0' '+',
+ * a width, a precision (%.3f, %.8s) and the 'l' / 'll' / 'h' length
+ * modifiers. '*' width or precision is not supported. Output stops at
+ * the first unknown conversion: its argument cannot be skipped. Floats
+ * beyond ±4294967040 print as "ovf", like Arduino's Print; exact halves
+ * round away from zero (glibc rounds them to even).
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <math.h>
+
+namespace InstantIoT {
+
+class BoundedWriter {
+public:
+    BoundedWriter(char* out, size_t cap) : _out(out), _cap(cap) {
+        if (_cap) _out[0] = '\0';
+    }
+
+    void put(char c) {
+        if (_len + 1 < _cap) { _out[_len++] = c; _out[_len] = '\0'; }
+    }
+
+    void pad(char c, int n) { while (n-- > 0) put(c); }
+
+    // `s` (n chars) padded to `width`; zero padding goes after the sign
+    void field(const char* s, size_t n, int width, bool left, bool zero) {
+        int fill = width - (int)n;
+        if (!left && zero && n && (s[0] == '-' || s[0] == '+')) { put(*s++); n--; }
+        if (!left) pad(zero ? '0' : ' ', fill);
+        while (n--) put(*s++);
+        if (left) pad(' ', fill);
+    }
+
+    size_t length() const { return _len; }
+
+private:
+    char*  _out;
+    size_t _cap;
+    size_t _len = 0;
+};
+
+// Digits of `v` in `base`, written backwards from `end`; returns the start
+inline char* formatDigits(char* end, unsigned long long v, uint8_t base, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do { *--end = digits[v % base]; v /= base; } while (v);
+    return end;
+}
+
+inline size_t vformatTo(char* out, size_t cap, const char* fmt, va_list ap) {
+    BoundedWriter w(out, cap);
+    char num[32];                       // u64: 20 decimal digits + sign (%f needs 21 too)
+
+    while (fmt && *fmt) {
+        if (*fmt != '%') { w.put(*fmt++); continue; }
+        fmt++;
+
+        bool left = false, zero = false, plus = false;
+        for (;; fmt++) {
+            if      (*fmt == '-') left = true;
+            else if (*fmt == '0') zero = true;
+            else if (*fmt == '+') plus = true;
+            else break;
+        }
+        int width = 0;
+        while (*fmt >= '0' && *fmt <= '9') width = width * 10 + (*fmt++ - '0');
+        int prec = -1;
+        if (*fmt == '.') {
+            fmt++; prec = 0;
+            while (*fmt >= '0' && *fmt <= '9') prec = prec * 10 + (*fmt++ - '0');
+        }
+        uint8_t lng = 0;
+        while (*fmt == 'l' || *fmt == 'h') { if (*fmt == 'l') lng++; fmt++; }
+
+        char* const end = num + sizeof(num);
+        switch (char c = *fmt ? *fmt++ : '\0') {
+            case 'd': case 'i': {
+                long long v = lng >= 2 ? va_arg(ap, long long)
+                            : lng == 1 ? (long long)va_arg(ap, long)
+                            : (long long)va_arg(ap, int);
+                unsigned long long m = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+                char* s = formatDigits(end, m, 10, false);
+                if (v < 0) *--s = '-'; else if (plus) *--s = '+';
+                w.field(s, end - s, width, left, zero);
+                break;
+            }
+            case 'u': case 'x': case 'X': {
+                unsigned long long v = lng >= 2 ? va_arg(ap, unsigned long long)
+                                     : lng == 1 ? (unsigned long long)va_arg(ap, unsigned long)
+                                     : (unsigned long long)va_arg(ap, unsigned int);
+                char* s = formatDigits(end, v, c == 'u' ? 10 : 16, c == 'X');
+                w.field(s, end - s, width, left, zero);
+                break;
+            }
+            case 'c': {
+                const char ch = (char)va_arg(ap, int);
+                w.field(&ch, 1, width, left, false);
+                break;
+            }
+            case 's': {
+                const char* s = va_arg(ap, const char*);
+                if (!s) s = "(null)";
+                size_t n = 0;
+                while (s[n] && (prec < 0 || n < (size_t)prec)) n++;
+                w.field(s, n, width, left, false);
+                break;
+            }
+            case 'f': {
+                double v = va_arg(ap, double);
+                if (prec < 0) prec = 6;
+                if (prec > 9) prec = 9;
+                const char* special = isnan(v) ? "nan" : isinf(v) ? (v < 0 ? "-inf" : "inf")
+                                    : (v > 4294967040.0 || v < -4294967040.0) ? "ovf" : nullptr;
+                if (special) { w.field(special, strlen(special), width, left, false); break; }
+
+                const bool neg = v < 0;
+                if (neg) v = -v;
+                uint32_t scale = 1;
+                for (int i = 0; i < prec; i++) scale *= 10;
+                v += 0.5 / scale;                               // round half up
+                unsigned long long ip = (unsigned long long)v;
+                uint32_t fp = (uint32_t)((v - (double)ip) * scale);
+                if (fp >= scale) { fp -= scale; ip++; }
+
+                char* s = end;
+                if (prec > 0) {
+                    for (int i = 0; i < prec; i++) { *--s = (char)('0' + fp % 10); fp /= 10; }
+                    *--s = '.';
+                }
+                s = formatDigits(s, ip, 10, false);
+                if (neg) *--s = '-'; else if (plus) *--s = '+';
+                w.field(s, end - s, width, left, zero);
+                break;
+            }
+            case '%': w.put('%'); break;
+            case '\0': break;                            // lone '%' at the end
+            default:                                     // unknown: its argument
+                return w.length();                       // can't be skipped, stop here
+        }
+    }
+    return w.length();
+}
+
+/**
+ * printf-style formatting into `out` (`cap` bytes, NUL included).
+ * @return characters written (after truncation)
+ */
+inline size_t formatTo(char* out, size_t cap, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+inline size_t formatTo(char* out, size_t cap, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    const size_t n = vformatTo(out, cap, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+} // namespace InstantIoT
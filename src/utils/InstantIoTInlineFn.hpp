@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * ============================================================
+ * 📦 InstantIoTInlineFn.hpp - Fixed-capacity callable, no heap
+ * ============================================================
+ *
+ * Stores any callable (capturing lambda, functor, function pointer)
+ * whose size fits in N bytes, inside the object itself. Unlike
+ * std::function there is no allocation, ever: a capture that is too
+ * large fails at compile time.
+ *
+ * Usage:
+ *   InlineFn<16> fn;
+ *   int pin = 4;
+ *   fn.assign([pin]{ digitalWrite(pin, !digitalRead(pin)); });
+ *   fn();
+ *
+ * Cost: one indirect call through a per-type trampoline, same as a
+ * `void (*)(void*)` callback with a context pointer.
+ *
+ * Non-copyable on purpose (the stored object may not be trivially
+ * copyable): keep it in place, re-assign() to change it.
+ *
+ * ============================================================
+ */
+
+#include <stddef.h>
+#include <new>
+
+template<size_t N>
+class InlineFn {
+public:
+    InlineFn() = default;
+    ~InlineFn() { reset(); }
+
+    InlineFn(const InlineFn&) = delete;
+    InlineFn& operator=(const InlineFn&) = delete;
+
+    /**
+     * Stores a copy of `f` (compile error if it does not fit in N bytes)
+     */
+    template<typename F>
+    void assign(F&& f) {
+        using T = typename Decay<F>::Type;
+        static_assert(sizeof(T) <= N, "InlineFn: callable too large, raise N");
+        static_assert(alignof(T) <= alignof(Storage), "InlineFn: callable over-aligned");
+        reset();
+        new (storage_.bytes) T(static_cast<F&&>(f));
+        call_    = &callImpl<T>;
+        destroy_ = &destroyImpl<T>;
+    }
+
+    /**
+     * Destroys the stored callable
+     */
+    void reset() {
+        if (destroy_) destroy_(storage_.bytes);
+        call_    = nullptr;
+        destroy_ = nullptr;
+    }
+
+    explicit operator bool() const { return call_ != nullptr; }
+
+    void operator()() { call_(storage_.bytes); }
+
+    /**
+     * Adapter for `void (*)(void*)` APIs: pass `&InlineFn::invoke`
+     * and the InlineFn itself as context.
+     */
+    static void invoke(void* self) {
+        (*static_cast<InlineFn*>(self))();
+    }
+
+private:
+    union Storage {
+        unsigned char bytes[N > 0 ? N : 1];
+        void*         ptr;
+        long long     ll;
+        double        d;
+    };
+
+    template<typename T> struct Decay            { typedef T Type; };
+    template<typename T> struct Decay<T&>        { typedef T Type; };
+    template<typename T> struct Decay<T&&>       { typedef T Type; };
+    template<typename T> struct Decay<const T>   { typedef T Type; };
+    template<typename T> struct Decay<const T&>  { typedef T Type; };
+    template<typename R> struct Decay<R()>       { typedef R (*Type)(); };
+    template<typename R> struct Decay<R(&)()>    { typedef R (*Type)(); };
+
+    template<typename T>
+    static void callImpl(void* p)    { (*static_cast<T*>(p))(); }
+
+    template<typename T>
+    static void destroyImpl(void* p) { static_cast<T*>(p)->~T(); }
+
+    Storage storage_;
+    void (*call_)(void*)    = nullptr;
+    void (*destroy_)(void*) = nullptr;
+};
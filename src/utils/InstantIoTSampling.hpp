@@ -0,0 +1,349 @@
+#pragma once
+/**
+ * ============================================================
+ * 🧪 InstantIoTSampling.hpp - Sample → aggregate → widget pipeline
+ * ============================================================
+ *
+ * Usage:
+ *   InstantTimer timers;
+ *   SamplingPipeline<64> temp;                  // 64-sample sliding window
+ *
+ *   float readTemp() { return analogRead(A0) * 0.1f; }
+ *
+ *   void setup() {
+ *       instant.begin();
+ *       temp.sampleEvery(timers, 10, readTemp)  // 100 Hz
+ *           .publishEvery(timers, 500)          // 2 frames/s per sink
+ *           .to(instant.gauge("t"))             // window mean
+ *           .to(instant.metric("t_max"), STAT_MAX)
+ *           .to(instant.chart("t"), "rms", STAT_RMS);
+ *   }
+ *
+ *   void loop() {
+ *       instant.loop();
+ *       timers.run();
+ *   }
+ *
+ * Stages:
+ *   source   sampleEvery() reads a value on the InstantTimer grid
+ *            (missed ticks are skipped and counted, never bunched), or
+ *            push() from one other context - an ISR or a task - through
+ *            a lock-free SpscRing of RING samples.
+ *   window   WindowStats<WINDOW>: the last WINDOW samples, with O(1)
+ *            mean / variance (Welford, add + remove) and amortized O(1)
+ *            min / max (monotonic deques). tumbling() resets it after
+ *            each publish instead of sliding.
+ *   sinks    up to INSTANT_PIPELINE_SINKS widgets, each fed one
+ *            statistic of the window at every publish. Gauge and Metric
+ *            still go through their SendFilter.
+ *
+ * Everything is sized by the template arguments: no allocation, and a
+ * sample costs the same whatever the window holds. A window takes
+ * 12 x WINDOW bytes (values + two index deques).
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "InstantIoTTimer.hpp"
+#include "../core/InstantIoTSpscRing.hpp"
+#include "../core/InstantIoTMpscRing.hpp"     // atomicIncrement
+#include "../widgets/WidgetIncludes.hpp"
+
+#ifndef INSTANT_PIPELINE_SINKS
+  #define INSTANT_PIPELINE_SINKS 4
+#endif
+
+namespace InstantIoT {
+
+enum WindowStat : uint8_t {
+    STAT_LAST,
+    STAT_MEAN,
+    STAT_MIN,
+    STAT_MAX,
+    STAT_STDDEV,     // sample standard deviation (n - 1)
+    STAT_RMS,
+    STAT_COUNT,      // samples in the window
+};
+
+// ============================================================
+// 📐 SLIDING WINDOW STATISTICS
+// ============================================================
+
+template<size_t N>
+class WindowStats {
+public:
+    static_assert(N >= 1, "WindowStats: N must be at least 1");
+
+    /** Adds `x`, evicting the oldest sample once the window is full. */
+    void add(float x) {
+        const size_t slot = _head;         // the oldest sample's once full
+
+        if (_n == N) {
+            // Welford, reversed, for the sample leaving the window
+            const float old = _buf[slot];
+            _n--;
+            if (_n == 0) { _mean = 0; _m2 = 0; }
+            else {
+                const float d = old - _mean;
+                _mean -= d / (float)_n;
+                _m2   -= d * (old - _mean);
+            }
+            if (_min.size && _min.front() == slot) _min.popFront();
+            if (_max.size && _max.front() == slot) _max.popFront();
+        }
+
+        _n++;
+        const float d = x - _mean;
+        _mean += d / (float)_n;
+        _m2   += d * (x - _mean);
+        if (_m2 < 0) _m2 = 0;              // rounding after many removals
+
+        // every index kept is still inside the window: its slot is intact
+        while (_min.size && _buf[_min.back()] >= x) _min.popBack();
+        while (_max.size && _buf[_max.back()] <= x) _max.popBack();
+        _buf[slot] = x;
+        _min.pushBack((uint32_t)slot);
+        _max.pushBack((uint32_t)slot);
+        _head = slot + 1 == N ? 0 : slot + 1;
+    }
+
+    void reset() { _n = 0; _head = 0; _mean = 0; _m2 = 0; _min.size = 0; _max.size = 0; }
+
+    size_t count()   const { return _n; }
+    bool   empty()   const { return _n == 0; }
+    float  last()    const { return _n ? _buf[_head ? _head - 1 : N - 1] : NAN; }
+    float  mean()    const { return _n ? _mean : NAN; }
+    float  minimum() const { return _n ? _buf[_min.front()] : NAN; }
+    float  maximum() const { return _n ? _buf[_max.front()] : NAN; }
+
+    /** Population variance of the window. */
+    float variance() const { return _n ? _m2 / (float)_n : NAN; }
+
+    /** Sample standard deviation (0 with a single sample). */
+    float stddev() const {
+        if (!_n) return NAN;
+        return _n > 1 ? sqrtf(_m2 / (float)(_n - 1)) : 0.0f;
+    }
+
+    /** sqrt(mean(x²)) = sqrt(mean² + variance). */
+    float rms() const { return _n ? sqrtf(_mean * _mean + _m2 / (float)_n) : NAN; }
+
+    float get(WindowStat s) const {
+        switch (s) {
+            case STAT_LAST:   return last();
+            case STAT_MEAN:   return mean();
+            case STAT_MIN:    return minimum();
+            case STAT_MAX:    return maximum();
+            case STAT_STDDEV: return stddev();
+            case STAT_RMS:    return rms();
+            case STAT_COUNT:  return (float)_n;
+        }
+        return NAN;
+    }
+
+private:
+    // Slots of candidate extremes, oldest first; never more than N
+    struct Deque {
+        uint32_t idx[N];
+        size_t   head = 0, size = 0;
+
+        uint32_t front() const { return idx[head]; }
+        uint32_t back()  const { return idx[(head + size - 1) % N]; }
+        void popFront() { head = (head + 1) % N; size--; }
+        void popBack()  { size--; }
+        void pushBack(uint32_t i) { idx[(head + size) % N] = i; size++; }
+    };
+
+    float    _buf[N];
+    Deque    _min, _max;
+    size_t   _head  = 0;         // next slot, wraps at N (no counter to overflow)
+    size_t   _n     = 0;
+    float    _mean  = 0, _m2 = 0;
+};
+
+// ============================================================
+// 🧪 PIPELINE
+// ============================================================
+
+template<size_t WINDOW, size_t RING = 16>
+class SamplingPipeline {
+public:
+    using ReadFn    = float (*)();
+    using ReadCtxFn = float (*)(void* ctx);
+
+    // ─── Source ──────────────────────────────────────────────
+
+    /**
+     * Samples `fn()` every `ms` on `timers`.
+     * @return *this (samplerId() is -1 if no timer slot was free)
+     */
+    SamplingPipeline& sampleEvery(InstantTimer& timers, uint32_t ms, ReadFn fn) {
+        _read = fn; _readCtx = nullptr;
+        return startSampler(timers, ms);
+    }
+
+    SamplingPipeline& sampleEvery(InstantTimer& timers, uint32_t ms, ReadCtxFn fn, void* ctx) {
+        _read = nullptr; _readCtx = fn; _ctx = ctx;
+        return startSampler(timers, ms);
+    }
+
+    /**
+     * Hands over a sample from ONE other context (ISR, task). Lock-free;
+     * the ring is drained by the sampler tick, publish() or drain().
+     * @return false if the ring was full (sample dropped and counted)
+     */
+    bool push(float v) {
+        if (_ring.push(v)) return true;
+        atomicIncrement(_dropped);
+        return false;
+    }
+
+    // ─── Output ──────────────────────────────────────────────
+
+    /** Publishes the window to the sinks every `ms` on `timers`. */
+    SamplingPipeline& publishEvery(InstantTimer& timers, uint32_t ms) {
+        _publishId = timers.every(ms, &SamplingPipeline::publishTick, this);
+        return *this;
+    }
+
+    /** Empties the window after each publish (tumbling, not sliding). */
+    SamplingPipeline& tumbling(bool on = true) { _tumbling = on; return *this; }
+
+#ifdef INSTANTIOT_WIDGETS_GAUGE
+    SamplingPipeline& to(GaugeWidget& w, WindowStat s = STAT_MEAN) {
+        return addSink(SINK_GAUGE, &w, nullptr, s);
+    }
+#endif
+
+#ifdef INSTANTIOT_WIDGETS_METRIC
+    SamplingPipeline& to(MetricWidget& w, WindowStat s = STAT_MEAN) {
+        return addSink(SINK_METRIC, &w, nullptr, s);
+    }
+#endif
+
+#ifdef INSTANTIOT_WIDGETS_ADVANCEDCHART
+    /** `seriesId` is kept by pointer: use a literal or static storage. */
+    SamplingPipeline& to(AdvancedChartWidget& w, const char* seriesId, WindowStat s = STAT_MEAN) {
+        return addSink(SINK_CHART, &w, seriesId, s);
+    }
+#endif
+
+    // ─── Manual driving (no timers) ──────────────────────────
+
+    /** Adds one sample directly (same context as publish()). */
+    void add(float v) { drain(); _stats.add(v); }
+
+    /** Moves the samples queued by push() into the window. */
+    size_t drain() {
+        size_t n = 0;
+        while (float* v = _ring.front()) {
+            _stats.add(*v);
+            _ring.pop();
+            n++;
+        }
+        return n;
+    }
+
+    /** Sends the current window to every sink (nothing if it is empty). */
+    void publish() {
+        drain();
+        if (_stats.empty()) return;
+        for (uint8_t i = 0; i < _sinkCount; i++) send(_sinks[i]);
+        if (_tumbling) _stats.reset();
+    }
+
+    // ─── Inspection ──────────────────────────────────────────
+
+    const WindowStats<WINDOW>& stats() const { return _stats; }
+    uint32_t dropped()     const { return _dropped; }   // ring full in push()
+    uint32_t missed()      const { return _missed; }    // sampler ticks skipped
+    int      samplerId()   const { return _samplerId; }
+    int      publisherId() const { return _publishId; }
+
+private:
+    enum SinkKind : uint8_t { SINK_GAUGE, SINK_METRIC, SINK_CHART };
+
+    struct Sink {
+        void*       widget;
+        const char* series;
+        SinkKind    kind;
+        WindowStat  stat;
+    };
+
+    SamplingPipeline& startSampler(InstantTimer& timers, uint32_t ms) {
+        _periodMs  = ms;
+        _lastTick  = millis();
+        _samplerId = timers.every(ms, &SamplingPipeline::sampleTick, this);
+        return *this;
+    }
+
+    SamplingPipeline& addSink(SinkKind kind, void* w, const char* series, WindowStat s) {
+        if (_sinkCount < INSTANT_PIPELINE_SINKS) {
+            _sinks[_sinkCount++] = Sink{ w, series, kind, s };
+        } else {
+            IIOT_LOG("[Pipeline] sink table full");
+        }
+        return *this;
+    }
+
+    static void sampleTick(void* ctx) {
+        SamplingPipeline* p = static_cast<SamplingPipeline*>(ctx);
+        // InstantTimer stays on its grid and skips late ticks: count them
+        const uint32_t now = millis();
+        if (p->_periodMs && now - p->_lastTick >= 2 * p->_periodMs) {
+            p->_missed += (now - p->_lastTick) / p->_periodMs - 1;
+        }
+        p->_lastTick = now;
+        p->add(p->_read ? p->_read() : p->_readCtx(p->_ctx));
+    }
+
+    static void publishTick(void* ctx) { static_cast<SamplingPipeline*>(ctx)->publish(); }
+
+    void send(const Sink& s) {
+        const float v = _stats.get(s.stat);
+        switch (s.kind) {
+#ifdef INSTANTIOT_WIDGETS_GAUGE
+            case SINK_GAUGE:  static_cast<GaugeWidget*>(s.widget)->setValue(v); break;
+#endif
+#ifdef INSTANTIOT_WIDGETS_METRIC
+            case SINK_METRIC: static_cast<MetricWidget*>(s.widget)->setValue(v); break;
+#endif
+#ifdef INSTANTIOT_WIDGETS_ADVANCEDCHART
+            case SINK_CHART:  static_cast<AdvancedChartWidget*>(s.widget)->addPoint(s.series, v); break;
+#endif
+            default: (void)v; break;
+        }
+    }
+
+    WindowStats<WINDOW>     _stats;
+    SpscRing<float, RING>   _ring;
+    Sink                    _sinks[INSTANT_PIPELINE_SINKS];
+    uint8_t                 _sinkCount = 0;
+    bool                    _tumbling  = false;
+
+    ReadFn            _read      = nullptr;
+    ReadCtxFn         _readCtx   = nullptr;
+    void*             _ctx       = nullptr;
+    uint32_t          _periodMs  = 0;
+    uint32_t          _lastTick  = 0;
+    int               _samplerId = -1;
+    int               _publishId = -1;
+    uint32_t          _missed    = 0;
+    volatile uint32_t _dropped   = 0;
+};
+
+} // namespace InstantIoT
+
+using InstantIoT::WindowStats;
+using InstantIoT::SamplingPipeline;
+using InstantIoT::WindowStat;
+using InstantIoT::STAT_LAST;
+using InstantIoT::STAT_MEAN;
+using InstantIoT::STAT_MIN;
+using InstantIoT::STAT_MAX;
+using InstantIoT::STAT_STDDEV;
+using InstantIoT::STAT_RMS;
+using InstantIoT::STAT_COUNT;
@@ -17,6 +17,21 @@
  *       timers.run();
  *   }
  *
+ * Context callbacks — one function shared by many timers:
+ *   void readSensor(void* ctx) { static_cast<Sensor*>(ctx)->read(); }
+ *   timers.every(1000, readSensor, &sensors[i]);
+ *
+ * Capturing lambdas — stored inline in the slot (InlineFn, no heap),
+ * up to INSTANT_TIMER_INLINE_SIZE bytes of captures:
+ *   timers.every(1000, [i]{ sensors[i].read(); });
+ *
+ * Engines (INSTANT_TIMER_ENGINE):
+ *   INSTANT_TIMER_SCAN (default) — run() walks every slot, in id order.
+ *   INSTANT_TIMER_HEAP           — armed timers sit in a binary min-heap
+ *     keyed on their next deadline: an idle run() is a single compare,
+ *     a firing costs O(log n), due timers run in deadline order.
+ *   Both keep the same API and the same wraparound-safe millis math.
+ *
  * ============================================================
  */
 
@@ -30,9 +45,31 @@
   #define INSTANT_DEBUG 0
 #endif
 
+// Capture bytes per slot for capturing lambdas (0 = feature off,
+// captureless lambdas still convert to Fn)
+#ifndef INSTANT_TIMER_INLINE_SIZE
+  #if defined(__AVR__)
+    #define INSTANT_TIMER_INLINE_SIZE 0
+  #else
+    #define INSTANT_TIMER_INLINE_SIZE 16
+  #endif
+#endif
+
+#if INSTANT_TIMER_INLINE_SIZE > 0
+  #include "InstantIoTInlineFn.hpp"
+#endif
+
+#define INSTANT_TIMER_SCAN 0
+#define INSTANT_TIMER_HEAP 1
+
+#ifndef INSTANT_TIMER_ENGINE
+  #define INSTANT_TIMER_ENGINE INSTANT_TIMER_SCAN
+#endif
+
 class InstantTimer {
 public:
-    using Fn = void (*)();
+    using Fn    = void (*)();
+    using CtxFn = void (*)(void* ctx);
 
     // ============================================================
     // 🎯 FLUENT API FOR SCHEDULING
@@ -45,7 +82,7 @@ public:
      * @return Timer ID (-1 on error)
      */
     int every(uint32_t ms, Fn fn) {
-        return schedule(ms, fn, 0, true);
+        return schedule(ms, fn, nullptr, nullptr, 0, true);
     }
 
     /**
@@ -55,7 +92,7 @@ public:
      * @return Timer ID (-1 on error)
      */
     int once(uint32_t ms, Fn fn) {
-        return schedule(ms, fn, 1, true);
+        return schedule(ms, fn, nullptr, nullptr, 1, true);
     }
 
     /**
@@ -66,9 +103,52 @@ public:
      * @return Timer ID (-1 on error)
      */
     int times(uint32_t ms, Fn fn, uint16_t n) {
-        return schedule(ms, fn, n, true);
+        return schedule(ms, fn, nullptr, nullptr, n, true);
     }
 
+    // ============================================================
+    // 🧩 CONTEXT CALLBACKS
+    // ============================================================
+
+    /**
+     * Same as every(), `fn(ctx)` is called at each tick
+     * @param ctx User pointer, must outlive the timer
+     */
+    int every(uint32_t ms, CtxFn fn, void* ctx) {
+        return schedule(ms, nullptr, fn, ctx, 0, true);
+    }
+
+    int once(uint32_t ms, CtxFn fn, void* ctx) {
+        return schedule(ms, nullptr, fn, ctx, 1, true);
+    }
+
+    int times(uint32_t ms, CtxFn fn, void* ctx, uint16_t n) {
+        return schedule(ms, nullptr, fn, ctx, n, true);
+    }
+
+#if INSTANT_TIMER_INLINE_SIZE > 0
+    // ============================================================
+    // 📦 CAPTURING LAMBDAS (stored inline, no heap)
+    // ============================================================
+
+    using Inline = InlineFn<INSTANT_TIMER_INLINE_SIZE>;
+
+    template<typename F>
+    int every(uint32_t ms, F&& f) {
+        return scheduleInline(ms, static_cast<F&&>(f), 0);
+    }
+
+    template<typename F>
+    int once(uint32_t ms, F&& f) {
+        return scheduleInline(ms, static_cast<F&&>(f), 1);
+    }
+
+    template<typename F>
+    int times(uint32_t ms, F&& f, uint16_t n) {
+        return scheduleInline(ms, static_cast<F&&>(f), n);
+    }
+#endif
+
     // ============================================================
     // 🔧 TIMER CONTROL
     // ============================================================
@@ -85,7 +165,11 @@ public:
 #endif
             return false;
         }
-        tasks_[id].active = en;
+        if (tasks_[id].active != en) {
+            tasks_[id].active = en;
+            if (en) { activeCount_++; arm(id); }
+            else    { activeCount_--; disarm(id); }
+        }
 #if INSTANT_DEBUG
         Serial.print(F("[Timer] "));
         Serial.print(en ? F("✅ Enabled") : F("⏸️ Disabled"));
@@ -119,7 +203,7 @@ public:
         Serial.print(id);
         Serial.println(F(" cancelled"));
 #endif
-        tasks_[id] = Task{};
+        release(id);
         return true;
     }
 
@@ -159,6 +243,7 @@ public:
             return false;
         }
         tasks_[id].nextAt = millis();
+        rekey(id);
 #if INSTANT_DEBUG
         Serial.print(F("[Timer] ⚡ Forced immediate execution: id="));
         Serial.println(id);
@@ -184,39 +269,26 @@ public:
         running_ = true;
 
         const uint32_t now = millis();
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+        // ⚡ Idle: one compare against the earliest deadline. Each timer
+        // fires at most once per run(), even if a callback re-arms it
+        // in the past (executeNow on itself).
+        int budget = heapSize_;
+        while (budget-- > 0 && heapSize_ > 0) {
+            const int i = heap_[0];
+            if ((int32_t)(now - tasks_[i].nextAt) < 0) break;
+            fire(i, now);
+        }
+#else
         for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
             Task& t = tasks_[i];
 
-            if (!t.inUse || !t.active || !t.fn) continue;
+            if (!t.inUse || !t.active || !t.callable()) continue;
             if ((int32_t)(now - t.nextAt) < 0) continue;
 
-            // ⏰ Schedule the next execution
-            if (t.interval > 0) {
-                do {
-                    t.nextAt += t.interval;
-                } while ((int32_t)(now - t.nextAt) >= 0);
-            } else {
-                t.nextAt = now + 1; // 🛡️ Safety if interval==0
-            }
-
-#if INSTANT_DEBUG
-            Serial.print(F("[Timer] 🔔 Executing timer id="));
-            Serial.println(i);
-#endif
-
-            Fn callback = t.fn;
-            callback();
-
-            // 📉 Decrement and release if finished
-            if (t.remaining > 0 && --t.remaining == 0) {
-#if INSTANT_DEBUG
-                Serial.print(F("[Timer] ✅ Timer id="));
-                Serial.print(i);
-                Serial.println(F(" finished"));
-#endif
-                t = Task{};
-            }
+            fire(i, now);
         }
+#endif
 
         running_ = false;
     }
@@ -229,22 +301,14 @@ public:
      * Number of active timers
      */
     int activeCount() const {
-        int count = 0;
-        for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
-            if (tasks_[i].inUse && tasks_[i].active) count++;
-        }
-        return count;
+        return activeCount_;
     }
 
     /**
      * Number of used slots
      */
     int usedCount() const {
-        int count = 0;
-        for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
-            if (tasks_[i].inUse) count++;
-        }
-        return count;
+        return usedCount_;
     }
 
     /**
@@ -254,21 +318,223 @@ public:
         return INSTANT_TIMERS_MAX - usedCount();
     }
 
+    /**
+     * Milliseconds until the next enabled timer is due: 0 if one is
+     * already due, UINT32_MAX if none is enabled. Lets the caller sleep
+     * until then (see InstantIoTCoreBase::idle()).
+     */
+    uint32_t nextDueInMs() const {
+        const uint32_t now = millis();
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+        if (heapSize_ == 0) return UINT32_MAX;
+        const int32_t d = (int32_t)(tasks_[heap_[0]].nextAt - now);
+        return d > 0 ? (uint32_t)d : 0;
+#else
+        uint32_t best = UINT32_MAX;
+        for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
+            const Task& t = tasks_[i];
+            if (!t.inUse || !t.active || !t.callable()) continue;
+            const int32_t d = (int32_t)(t.nextAt - now);
+            if (d <= 0) return 0;
+            if ((uint32_t)d < best) best = (uint32_t)d;
+        }
+        return best;
+#endif
+    }
+
 private:
     struct Task {
         Fn       fn        = nullptr;
+        CtxFn    ctxFn     = nullptr;   // used when fn == nullptr
+        void*    ctx       = nullptr;
         uint32_t interval  = 0;
         uint32_t nextAt    = 0;
         uint16_t remaining = 0;   // 0 = infinite
+        uint8_t  gen       = 0;   // bumped on release (detects reuse)
         bool     active    = false;
         bool     inUse     = false;
+
+        bool callable() const { return fn || ctxFn; }
     };
 
     Task tasks_[INSTANT_TIMERS_MAX];
     bool running_ = false; // 🔒 Protection against nested loops
+    int  activeCount_ = 0;
+    int  usedCount_   = 0;
+    int  firing_      = -1;    // slot whose callback is running
+
+#if INSTANT_TIMER_INLINE_SIZE > 0
+    Inline inline_[INSTANT_TIMERS_MAX];
+#endif
+
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+    // Min-heap of armed (inUse && active) slots, ordered by nextAt.
+    // heapPos_[id] = index in heap_, or -1 when not armed.
+    int16_t heap_[INSTANT_TIMERS_MAX];
+    int16_t heapPos_[INSTANT_TIMERS_MAX];
+    int     heapSize_ = 0;
+    // Free slot ids, popped from the top
+    int16_t free_[INSTANT_TIMERS_MAX];
+    int     freeTop_ = 0;
+    bool    init_    = false;
+#endif
+
+    /**
+     * Runs a due timer: reschedules it first (so the callback may
+     * cancel / re-arm it freely), then counts down its repetitions.
+     */
+    void fire(int i, uint32_t now) {
+        Task& t = tasks_[i];
+
+        // ⏰ Schedule the next execution
+        if (t.interval > 0) {
+            do {
+                t.nextAt += t.interval;
+            } while ((int32_t)(now - t.nextAt) >= 0);
+        } else {
+            t.nextAt = now + 1; // 🛡️ Safety if interval==0
+        }
+        rekey(i);
 
-    int schedule(uint32_t ms, Fn fn, uint16_t repeat, bool en) {
-        if (!fn) {
+#if INSTANT_DEBUG
+        Serial.print(F("[Timer] 🔔 Executing timer id="));
+        Serial.println(i);
+#endif
+
+        const uint8_t gen = t.gen;
+        firing_ = i;
+        if (t.fn) t.fn();
+        else      t.ctxFn(t.ctx);
+        firing_ = -1;
+
+        // Slot cancelled by the callback: finish the release deferred
+        // while it was running (its lambda could not be destroyed)
+        if (!t.inUse) { recycle(i); return; }
+        if (t.gen != gen) return;
+
+        // 📉 Decrement and release if finished
+        if (t.remaining > 0 && --t.remaining == 0) {
+#if INSTANT_DEBUG
+            Serial.print(F("[Timer] ✅ Timer id="));
+            Serial.print(i);
+            Serial.println(F(" finished"));
+#endif
+            release(i);
+        }
+    }
+
+    void release(int id) {
+        Task& t = tasks_[id];
+        if (!t.inUse) return;
+        if (t.active) { activeCount_--; disarm(id); }
+        usedCount_--;
+        const uint8_t gen = t.gen;
+        t = Task{};
+        t.gen = (uint8_t)(gen + 1);
+        // A timer cancelled from its own callback stays reserved
+        // until the callback returns (see fire())
+        if (id != firing_) recycle(id);
+    }
+
+    void recycle(int id) {
+#if INSTANT_TIMER_INLINE_SIZE > 0
+        inline_[id].reset();
+#endif
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+        free_[freeTop_++] = (int16_t)id;
+#else
+        (void)id;
+#endif
+    }
+
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+    void initSlots() {
+        if (init_) return;
+        init_ = true;
+        for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
+            heapPos_[i] = -1;
+            // Lowest ids first, like the scan engine
+            free_[i] = (int16_t)(INSTANT_TIMERS_MAX - 1 - i);
+        }
+        freeTop_ = INSTANT_TIMERS_MAX;
+    }
+
+    // Wraparound-safe: valid while deadlines are < 2^31 ms apart
+    bool before(int a, int b) const {
+        return (int32_t)(tasks_[a].nextAt - tasks_[b].nextAt) < 0;
+    }
+
+    void place(int pos, int id) {
+        heap_[pos] = (int16_t)id;
+        heapPos_[id] = (int16_t)pos;
+    }
+
+    void siftUp(int pos) {
+        const int id = heap_[pos];
+        while (pos > 0) {
+            const int parent = (pos - 1) / 2;
+            if (!before(id, heap_[parent])) break;
+            place(pos, heap_[parent]);
+            pos = parent;
+        }
+        place(pos, id);
+    }
+
+    void siftDown(int pos) {
+        const int id = heap_[pos];
+        for (;;) {
+            int child = 2 * pos + 1;
+            if (child >= heapSize_) break;
+            if (child + 1 < heapSize_ && before(heap_[child + 1], heap_[child])) child++;
+            if (!before(heap_[child], id)) break;
+            place(pos, heap_[child]);
+            pos = child;
+        }
+        place(pos, id);
+    }
+
+    void arm(int id) {
+        if (heapPos_[id] >= 0) return;
+        place(heapSize_++, id);
+        siftUp(heapSize_ - 1);
+    }
+
+    void disarm(int id) {
+        const int pos = heapPos_[id];
+        if (pos < 0) return;
+        heapPos_[id] = -1;
+        const int last = heap_[--heapSize_];
+        if (pos == heapSize_) return;
+        place(pos, last);
+        siftUp(pos);
+        siftDown(heapPos_[last]);
+    }
+
+    void rekey(int id) {
+        const int pos = heapPos_[id];
+        if (pos < 0) return;
+        siftUp(pos);
+        siftDown(heapPos_[id]);
+    }
+#else
+    void arm(int)    {}
+    void disarm(int) {}
+    void rekey(int)  {}
+#endif
+
+#if INSTANT_TIMER_INLINE_SIZE > 0
+    template<typename F>
+    int scheduleInline(uint32_t ms, F&& f, uint16_t repeat) {
+        const int id = schedule(ms, nullptr, &Inline::invoke, nullptr, repeat, true);
+        if (id < 0) return -1;
+        tasks_[id].ctx = &inline_[id];
+        inline_[id].assign(static_cast<F&&>(f));
+        return id;
+    }
+#endif
+
+    int schedule(uint32_t ms, Fn fn, CtxFn ctxFn, void* ctx, uint16_t repeat, bool en) {
+        if (!fn && !ctxFn) {
 #if INSTANT_DEBUG
             Serial.println(F("[Timer] ❌ Schedule impossible: callback null"));
 #endif
@@ -291,11 +557,15 @@ private:
         }
 
         tasks_[id].fn        = fn;
+        tasks_[id].ctxFn     = ctxFn;
+        tasks_[id].ctx       = ctx;
         tasks_[id].interval  = ms;
         tasks_[id].nextAt    = millis() + ms;
         tasks_[id].remaining = repeat;
         tasks_[id].active    = en;
         tasks_[id].inUse     = true;
+        usedCount_++;
+        if (en) { activeCount_++; arm(id); }
 
 #if INSTANT_DEBUG
         Serial.print(F("[Timer] ➕ Timer created: id="));
@@ -309,12 +579,19 @@ private:
         return id;
     }
 
+#if INSTANT_TIMER_ENGINE == INSTANT_TIMER_HEAP
+    int firstFree() {
+        initSlots();
+        return freeTop_ > 0 ? free_[--freeTop_] : -1;
+    }
+#else
     int firstFree() const {
         for (int i = 0; i < INSTANT_TIMERS_MAX; i++) {
-            if (!tasks_[i].inUse) return i;
+            if (!tasks_[i].inUse && i != firing_) return i;
         }
         return -1;
     }
+#endif
 
     static inline bool valid(int id) {
         return id >= 0 && id < INSTANT_TIMERS_MAX;
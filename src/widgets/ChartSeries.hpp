@@ -0,0 +1,264 @@
+#pragma once
+/**
+ * ============================================================
+ * 📈 ChartSeries.hpp — Per-series history + downsampling (AdvancedChart)
+ * ============================================================
+ *
+ * With INSTANTIOT_CHART_HISTORY, AdvancedChartWidget::push() feeds raw
+ * samples into a ChartSeries instead of sending each one:
+ *
+ *   instant.chart("vib").series("x").reduce(REDUCE_LTTB).every(200);
+ *   instant.chart("vib").push("x", readAccel());   // at 200 Hz
+ *
+ * Samples are grouped in time buckets of every() ms; when a bucket
+ * closes, its reducer yields the point(s) actually sent:
+ *
+ *   REDUCE_NONE    every sample, unbuffered (history only)
+ *   REDUCE_LAST    last sample of the bucket
+ *   REDUCE_MEAN    mean
+ *   REDUCE_MIN / REDUCE_MAX
+ *   REDUCE_MINMAX  min and max, in sampling order (keeps spikes)
+ *   REDUCE_LTTB    Largest-Triangle-Three-Buckets: the sample forming
+ *                  the largest triangle with the previously sent point
+ *                  and the mean of the next bucket. Needs the next
+ *                  bucket, so points leave one bucket late; picked from
+ *                  the raw window, which should hold two buckets.
+ *
+ * The raw window keeps the last INSTANTIOT_CHART_HISTORY_POINTS samples
+ * whatever the reducer; restore() sends it (LTTB-downsampled to
+ * INSTANTIOT_CHART_RESTORE_POINTS) with setSeriesData().
+ *
+ * x = sample index: LTTB assumes a steady sampling rate.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include <math.h>
+
+namespace InstantIoT {
+
+enum ChartReducer : uint8_t {
+    REDUCE_NONE,
+    REDUCE_LAST,
+    REDUCE_MEAN,
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_MINMAX,
+    REDUCE_LTTB,
+};
+
+/**
+ * Batch LTTB: keeps `m` of the `n` points of `in` (first and last
+ * included) into `out`. Copies when n <= m or m < 3.
+ * @return number of points written
+ */
+inline size_t lttbDownsample(const float* in, size_t n, float* out, size_t m) {
+    if (n <= m || m < 3) {
+        if (m > n) m = n;
+        memcpy(out, in, m * sizeof(float));
+        return m;
+    }
+    const float every = (float)(n - 2) / (float)(m - 2);
+    size_t a = 0;
+    out[0] = in[0];
+    for (size_t i = 0; i < m - 2; i++) {
+        // mean of the next bucket
+        size_t ns = (size_t)((i + 1) * every) + 1;
+        size_t ne = (size_t)((i + 2) * every) + 1;
+        if (ne > n) ne = n;
+        float cx = 0, cy = 0;
+        for (size_t j = ns; j < ne; j++) { cx += (float)j; cy += in[j]; }
+        cx /= (float)(ne - ns); cy /= (float)(ne - ns);
+
+        // this bucket: largest triangle with `a` and the mean
+        const size_t rs = (size_t)(i * every) + 1;
+        const size_t re = ns;
+        float best = -1;
+        size_t pick = rs;
+        for (size_t j = rs; j < re; j++) {
+            const float area = fabsf(((float)a - cx) * (in[j] - in[a]) -
+                                     ((float)a - (float)j) * (cy - in[a]));
+            if (area > best) { best = area; pick = j; }
+        }
+        out[i + 1] = in[pick];
+        a = pick;
+    }
+    out[m - 1] = in[n - 1];
+    return m;
+}
+
+class ChartSeries {
+public:
+    static const size_t WINDOW = INSTANTIOT_CHART_HISTORY_POINTS;
+    static_assert(WINDOW >= 2 && (WINDOW & (WINDOW - 1)) == 0,
+                  "INSTANTIOT_CHART_HISTORY_POINTS must be a power of 2");
+
+    // ─── Configuration (chainable) ───────────────────────────
+
+    ChartSeries& reduce(ChartReducer r) { _reducer = r; resetBuckets(); return *this; }
+    ChartSeries& every(uint16_t ms)     { _intervalMs = ms; return *this; }
+
+    // ─── Identity ────────────────────────────────────────────
+
+    void assign(const char* id) {
+        strncpy(_id, id ? id : "", sizeof(_id) - 1);
+        _id[sizeof(_id) - 1] = '\0';
+    }
+    const char* id() const { return _id; }
+    bool used() const { return _id[0] != '\0'; }
+
+    // ─── Raw window ──────────────────────────────────────────
+
+    size_t size() const { return _total < WINDOW ? (size_t)_total : WINDOW; }
+
+    /** i-th sample of the window, 0 = oldest. */
+    float at(size_t i) const { return _raw[(_total - size() + i) & (WINDOW - 1)]; }
+
+    /** Copies the window, oldest first; returns size(). */
+    size_t copyWindow(float* out) const {
+        const size_t n = size();
+        for (size_t i = 0; i < n; i++) out[i] = at(i);
+        return n;
+    }
+
+    void clear() { _total = 0; resetBuckets(); }
+
+    // ─── Sampling ────────────────────────────────────────────
+
+    /**
+     * Records `y` sampled at `now`. Points to send now go to `out`
+     * (up to 2: REDUCE_MINMAX).
+     * @return number of points written to `out`
+     */
+    uint8_t add(float y, uint32_t now, float* out) {
+        uint8_t n = poll(now, out);
+        if (_reducer == REDUCE_NONE) {
+            record(y);
+            out[n++] = y;
+            return n;
+        }
+        if (_count == 0) {
+            _t0 = now;
+            _start = _total;
+            _sum = 0; _first = _min = _max = y; _minAt = _maxAt = _total;
+        } else {
+            if (y < _min) { _min = y; _minAt = _total; }
+            if (y > _max) { _max = y; _maxAt = _total; }
+        }
+        _sum += y;
+        _last = y;
+        _count++;
+        record(y);
+        return n;
+    }
+
+    /** Closes the bucket if its time is up (no new sample needed). */
+    uint8_t poll(uint32_t now, float* out) {
+        if (_reducer == REDUCE_NONE) return 0;
+        if (_count) return (now - _t0 >= _intervalMs) ? close(now, out) : 0;
+        // LTTB tail: no next bucket came, send the held one anyway
+        if (_held && now - _closedAt >= _intervalMs) {
+            _held = false;
+            out[0] = pickHeld((float)(_heldEnd - 1 - _aX), _heldLast);
+            return 1;
+        }
+        return 0;
+    }
+
+    /** ms until poll() has something to do, UINT32_MAX if never. */
+    uint32_t dueInMs(uint32_t now) const {
+        if (_reducer == REDUCE_NONE) return UINT32_MAX;
+        uint32_t from;
+        if (_count)     from = _t0;
+        else if (_held) from = _closedAt;
+        else            return UINT32_MAX;
+        const uint32_t age = now - from;
+        return age >= _intervalMs ? 0 : _intervalMs - age;
+    }
+
+private:
+    void record(float y) {
+        _raw[_total & (WINDOW - 1)] = y;
+        _total++;
+    }
+
+    void resetBuckets() { _count = 0; _held = false; _hasA = false; }
+
+    uint8_t close(uint32_t now, float* out) {
+        uint8_t n = 0;
+        const float mean = _sum / (float)_count;
+        switch (_reducer) {
+            case REDUCE_LAST: out[n++] = _last; break;
+            case REDUCE_MEAN: out[n++] = mean;  break;
+            case REDUCE_MIN:  out[n++] = _min;  break;
+            case REDUCE_MAX:  out[n++] = _max;  break;
+            case REDUCE_MINMAX:
+                if (_minAt == _maxAt)     out[n++] = _min;
+                else if (_minAt < _maxAt) { out[n++] = _min; out[n++] = _max; }
+                else                      { out[n++] = _max; out[n++] = _min; }
+                break;
+            case REDUCE_LTTB: {
+                if (_held) {
+                    // c = mean of this bucket, x relative to a
+                    out[n++] = pickHeld((float)(_start - _aX) + (float)(_count - 1) * 0.5f, mean);
+                } else if (!_hasA) {
+                    // very first bucket: LTTB always keeps the first point
+                    out[n++] = _first;
+                    _aX = _start; _aY = _first; _hasA = true;
+                }
+                _held      = true;      // this bucket waits for the next one
+                _heldStart = _start;
+                _heldEnd   = _total;
+                _heldMean  = mean;
+                _heldLast  = _last;
+                break;
+            }
+            default: break;
+        }
+        _count = 0;
+        _closedAt = now;
+        return n;
+    }
+
+    // Point of the held bucket with the largest triangle (a, p, c);
+    // x coordinates relative to a (exact sample indices stay small)
+    float pickHeld(float cx, float cy) {
+        uint32_t from = _heldStart;
+        const uint32_t oldest = _total - (uint32_t)size();
+        if ((int32_t)(from - oldest) < 0) from = oldest;   // partly overwritten
+        float best = -1, pick = _heldMean;                // fully overwritten: mean
+        uint32_t pickAt = _heldStart;
+        for (uint32_t x = from; (int32_t)(_heldEnd - x) > 0; x++) {
+            const float y = _raw[x & (WINDOW - 1)];
+            const float px = (float)(x - _aX);
+            const float area = fabsf(cx * (y - _aY) - px * (cy - _aY));
+            if (area > best) { best = area; pick = y; pickAt = x; }
+        }
+        _aX = pickAt; _aY = pick; _hasA = true;
+        _held = false;
+        return pick;
+    }
+
+    char         _id[INSTANTIOT_SERIES_ID_LENGTH] = {0};
+    float        _raw[WINDOW];
+    uint32_t     _total = 0;            // samples recorded since clear()
+
+    ChartReducer _reducer    = REDUCE_NONE;
+    uint16_t     _intervalMs = 200;
+
+    // current bucket
+    uint32_t _t0 = 0, _start = 0, _minAt = 0, _maxAt = 0;
+    uint32_t _count = 0;
+    float    _sum = 0, _first = 0, _min = 0, _max = 0, _last = 0;
+    uint32_t _closedAt = 0;
+
+    // LTTB: last sent point (a) and the bucket waiting for its successor
+    bool     _hasA = false, _held = false;
+    uint32_t _aX = 0, _heldStart = 0, _heldEnd = 0;
+    float    _aY = 0, _heldMean = 0, _heldLast = 0;
+};
+
+} // namespace InstantIoT
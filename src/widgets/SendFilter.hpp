@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * ============================================================
+ * 🎚️ SendFilter.hpp — "changed enough?" filter for numeric setters
+ * ============================================================
+ *
+ * Every DisplayWidget owns one. GaugeWidget, MetricWidget and the level
+ * widgets run setValue() through it; a suppressed call costs a compare
+ * and returns without encoding anything:
+ *
+ *   instant.gauge("temp").filter()
+ *          .deadband(0.2f)        // ignore moves of ±0.2 or less
+ *          .hysteresis(0.3f)      // turning back needs 0.2 + 0.3
+ *          .minInterval(250)      // at most 4 frames/s
+ *          .maxInterval(30000);   // resend the value every 30 s anyway
+ *
+ * Rules, checked in this order on each call:
+ *   1. nothing sent yet (or reset())              → send
+ *   2. maxInterval elapsed since the last send    → send (forced refresh)
+ *   3. minInterval not elapsed yet                → drop
+ *   4. |value − shadow| > band                    → send, otherwise drop
+ * band = deadband (absolute) or deadband × |shadow| (relative), plus
+ * hysteresis when the move reverses the direction of the last sent
+ * change — a value hovering around a threshold does not flicker.
+ *
+ * The shadow is the last value sent successfully; a failed send keeps
+ * the old one so the next call retries. There is no timer: a value
+ * dropped by minInterval goes out on the next call once the interval
+ * has elapsed. With no rule configured every call is sent, as before.
+ *
+ * Copyright (c) 2025 InstantIoT — MIT License
+ * ============================================================
+ */
+
+#include <Arduino.h>
+#include <math.h>
+
+namespace InstantIoT {
+
+class SendFilter {
+public:
+    // ─── Configuration (chainable) ───────────────────────────
+
+    /** Absolute deadband: moves of ±band or less are dropped. */
+    SendFilter& deadband(float band) {
+        _band = band; setFlag(F_RELATIVE, false); setFlag(F_BAND, band > 0); return *this;
+    }
+
+    /** Relative deadband: `fraction` of the last sent value (0.01 = 1 %). */
+    SendFilter& relativeDeadband(float fraction) {
+        _band = fraction; setFlag(F_RELATIVE, true); setFlag(F_BAND, fraction > 0); return *this;
+    }
+
+    /** Extra band required when the value turns back. */
+    SendFilter& hysteresis(float band) {
+        _hyst = band; setFlag(F_HYST, band > 0); return *this;
+    }
+
+    /** Minimum time between two sends (0 = off, max 65535 ms). */
+    SendFilter& minInterval(uint16_t ms) { _minMs = ms; return *this; }
+
+    /** Forced refresh: send even an unchanged value after `ms` (0 = off). */
+    SendFilter& maxInterval(uint32_t ms) { _maxMs = ms; return *this; }
+
+    /** Removes every rule: each call sends again. */
+    SendFilter& clear() {
+        _flags &= F_SHADOW; _minMs = 0; _maxMs = 0; return *this;
+    }
+
+    /** Forgets the shadow: the next value is sent whatever it is. */
+    void reset() { _flags &= ~(F_SHADOW | F_UP | F_DOWN); }
+
+    // ─── Shadow ──────────────────────────────────────────────
+
+    bool  hasShadow() const { return _flags & F_SHADOW; }
+    float shadow()    const { return _shadow; }      // last value sent
+
+    // ─── Used by the widget setters ──────────────────────────
+
+    /** True if `v` must be sent. */
+    bool pass(float v) const {
+        if (!(_flags & F_SHADOW) || !active()) return true;
+        if (_minMs || _maxMs) {
+            const uint32_t age = millis() - _lastMs;
+            if (_maxMs && age >= _maxMs) return true;
+            if (age < _minMs) return false;
+        }
+        const float d = v - _shadow;
+        if (d != d) return !(v != v && _shadow != _shadow);   // NaN in or out
+        float band = (_flags & F_BAND)
+                   ? ((_flags & F_RELATIVE) ? _band * fabsf(_shadow) : _band)
+                   : 0.0f;
+        if ((_flags & F_HYST) && (_flags & (d > 0 ? F_DOWN : F_UP))) band += _hyst;
+        return fabsf(d) > band;
+    }
+
+    /** Records a successful send of `v`. */
+    void sent(float v) {
+        if (_flags & F_SHADOW) {
+            if (v > _shadow)      _flags = (_flags & ~F_DOWN) | F_UP;
+            else if (v < _shadow) _flags = (_flags & ~F_UP) | F_DOWN;
+        }
+        _shadow = v;
+        _flags |= F_SHADOW;
+        if (_minMs || _maxMs) _lastMs = millis();
+    }
+
+private:
+    enum : uint8_t {
+        F_BAND     = 0x01,
+        F_RELATIVE = 0x02,
+        F_HYST     = 0x04,
+        F_SHADOW   = 0x08,   // _shadow holds a sent value
+        F_UP       = 0x10,   // direction of the last sent change
+        F_DOWN     = 0x20,
+    };
+
+    bool active() const { return (_flags & (F_BAND | F_HYST)) || _minMs || _maxMs; }
+    void setFlag(uint8_t f, bool on) { _flags = on ? (_flags | f) : (_flags & ~f); }
+
+    float    _shadow = 0;
+    float    _band   = 0;
+    float    _hyst   = 0;
+    uint32_t _lastMs = 0;
+    uint32_t _maxMs  = 0;
+    uint16_t _minMs  = 0;
+    uint8_t  _flags  = 0;
+};
+
+} // namespace InstantIoT
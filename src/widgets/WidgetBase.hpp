@@ -2,6 +2,8 @@
 #include <Arduino.h>
 #include "../InstantIoTConfig.h"
 #include "../core/MessageSender.h"
+#include "../core/BinaryCodec.hpp"
+#include "SendFilter.hpp"
 
 namespace InstantIoT {
 
@@ -29,11 +31,64 @@ protected:
     ) {
         return _sender.sendBinary(_id, getTypeCode(), eventCode, payload, payloadLen);
     }
+
+    // Payload bytes one frame can carry for this widget
+    size_t maxPayload() const {
+        size_t n = _sender.maxPayloadLen(_id);
+        if (n) return n;
+        // unknown sender: assume a device id of the longest length
+        const size_t over = BinaryCodec::frameOverhead(nullptr, _id) + 1 + INSTANTIOT_MAX_WIDGET_ID_LENGTH;
+        return over < INSTANT_TX_BUFFER_SIZE ? INSTANT_TX_BUFFER_SIZE - over : 0;
+    }
+
+    // FNV-1a of a payload, for "same as last time?" checks (never 0)
+    static uint32_t payloadHash(const uint8_t* p, size_t len, uint32_t h = 2166136261u) {
+        while (len--) { h ^= *p++; h *= 16777619u; }
+        return h ? h : 1;
+    }
 };
 
+#if INSTANTIOT_STATE_RESYNC
+// Last value / range set on a Gauge or level widget
+struct RangedValueState {
+    float value = 0, min = 0, max = 0;
+    bool  hasValue = false, hasRange = false;
+};
+#endif
+
 class DisplayWidget : public WidgetBase {
 public:
     using WidgetBase::WidgetBase;
+
+    // Deadband / hysteresis / interval rules for setValue() — see SendFilter.hpp
+    SendFilter& filter() { return _filter; }
+
+    #if INSTANTIOT_STATE_RESYNC
+    // Most frames a resync() emits (LED: color + brightness + on/off +
+    // animation, AdvancedChart: one per buffered series)
+    #if INSTANTIOT_CHART_HISTORY && INSTANTIOT_CHART_SERIES > 4
+    static const uint8_t RESYNC_MAX_FRAMES = INSTANTIOT_CHART_SERIES;
+    #else
+    static const uint8_t RESYNC_MAX_FRAMES = 4;
+    #endif
+
+    // Re-sends the last state set by the sketch, unfiltered. Called by
+    // the core after each connect edge; no-op for stateless widgets.
+    virtual void resync() {}
+    #endif
+
+protected:
+    SendFilter _filter;
+
+    // Float setter through the filter; the shadow moves only on a successful send
+    bool sendFilteredFloat(uint8_t eventCode, float value) {
+        if (!_filter.pass(value)) return false;
+        uint8_t buf[4];
+        writeFloatLE(buf, value);
+        if (!sendBinary(eventCode, buf, 4)) return false;
+        _filter.sent(value);
+        return true;
+    }
 };
 
 } // namespace InstantIoT
\ No newline at end of file
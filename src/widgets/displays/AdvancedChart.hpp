@@ -2,11 +2,15 @@
 #include <Arduino.h>
 #include "../WidgetBase.hpp"
 #include "../../core/BinaryCodec.hpp"
+#if INSTANTIOT_CHART_HISTORY
+#include "../ChartSeries.hpp"
+#endif
 
 namespace InstantIoT {
 
 class AdvancedChartWidget : public DisplayWidget {
     int _pointIndex = 0;
+    uint64_t _timeBase = 0;   // server epoch ms, 0 = not sent yet
 
 public:
     AdvancedChartWidget(const char* id, IMessageSender& sender)
@@ -16,7 +20,7 @@ public:
 
     AdvancedChartWidget& addPoint(const char* seriesId, float y) {
         uint8_t buf[64]; size_t b = 0;
-        b += writeString(buf+b, seriesId);
+        b += writeString(buf+b, seriesId, sizeof(buf) - 5);
         writeFloatLE(buf+b, y); b += 4;
         sendBinary(EV_ADDPOINT, buf, b);
         _pointIndex++;
@@ -25,7 +29,7 @@ public:
 
     AdvancedChartWidget& addTimedPoint(const char* seriesId, float x, float y) {
         uint8_t buf[64]; size_t b = 0;
-        b += writeString(buf+b, seriesId);
+        b += writeString(buf+b, seriesId, sizeof(buf) - 9);
         writeFloatLE(buf+b, x); b += 4;
         writeFloatLE(buf+b, y); b += 4;
         sendBinary(EV_ADDTIMEDPOINT, buf, b);
@@ -34,6 +38,109 @@ public:
 
     AdvancedChartWidget& addPoint(float y) { return addPoint("default", y); }
 
+    /**
+     * Appends `count` points to one series, packed into as few frames
+     * as the TX buffer allows — one series header per frame instead of
+     * one frame per point.
+     *
+     * Payload format (EV_ADDPOINTS = 0x08):
+     *   [seriesId_len:u8 | seriesId_bytes | count:u16_LE | count × y:float_LE]
+     */
+    AdvancedChartWidget& addPoints(const char* seriesId, const float* ys, uint16_t count) {
+        if (!ys || count == 0) return *this;
+        uint8_t buf[INSTANT_TX_BUFFER_SIZE];
+        const size_t head = writeString(buf, seriesId, sizeof(buf) - 3);
+        const size_t perFrame = pointsPerFrame(head + 2, 4, sizeof(buf));
+        if (perFrame == 0) return *this;
+        for (uint16_t done = 0; done < count; ) {
+            const size_t left = (size_t)(count - done);
+            const uint16_t n = (uint16_t)(left < perFrame ? left : perFrame);
+            writeU16LE(buf + head, n);
+            for (uint16_t i = 0; i < n; i++) writeFloatLE(buf + head + 2 + i * 4, ys[done + i]);
+            if (!sendBinary(EV_ADDPOINTS, buf, head + 2 + n * 4)) break;
+            done += n;
+            _pointIndex += n;
+        }
+        return *this;
+    }
+
+    /**
+     * Appends `rowCount` samples to each of `seriesCount` series at once
+     * (same x for the series of a row). `rows` is interleaved row by
+     * row: rows[r * seriesCount + s] belongs to seriesIds[s].
+     *
+     * Payload format (EV_ADDPOINTS_MULTI = 0x09):
+     *   [seriesCount:u8 | seriesCount × (sid_len:u8 | sid_bytes)
+     *    | rows:u16_LE | rows × seriesCount × y:float_LE]
+     */
+    AdvancedChartWidget& addPoints(const char* const* seriesIds, uint8_t seriesCount,
+                                   const float* rows, uint16_t rowCount) {
+        if (!seriesIds || !rows || seriesCount == 0 || rowCount == 0) return *this;
+        uint8_t buf[INSTANT_TX_BUFFER_SIZE];
+        size_t head = 0;
+        buf[head++] = seriesCount;
+        for (uint8_t s = 0; s < seriesCount; s++) {
+            const size_t len = seriesIds[s] ? strlen(seriesIds[s]) : 0;
+            const size_t sid = 1 + (len < 255 ? len : 255);
+            if (head + sid + 2 > sizeof(buf)) return *this;
+            head += writeString(buf + head, seriesIds[s]);
+        }
+        const size_t perFrame = pointsPerFrame(head + 2, 4 * (size_t)seriesCount, sizeof(buf));
+        if (perFrame == 0) return *this;
+        for (uint16_t done = 0; done < rowCount; ) {
+            const size_t left = (size_t)(rowCount - done);
+            const uint16_t n = (uint16_t)(left < perFrame ? left : perFrame);
+            writeU16LE(buf + head, n);
+            uint8_t* p = buf + head + 2;
+            const float* src = rows + (size_t)done * seriesCount;
+            for (size_t i = 0; i < (size_t)n * seriesCount; i++, p += 4) writeFloatLE(p, src[i]);
+            if (!sendBinary(EV_ADDPOINTS_MULTI, buf, (size_t)(p - buf))) break;
+            done += n;
+            _pointIndex += n;
+        }
+        return *this;
+    }
+
+    /**
+     * Adds a point stamped with its sampling time instead of its
+     * arrival time on the server. Needs a synchronized clock
+     * (`instant.setTimeSync(...)`, server mode) — otherwise falls back
+     * to `addPoint`.
+     *
+     * The time travels as a u16 delta (ms) from a per-widget time base
+     * (EV_SETTIMEBASE, u64 server epoch ms), re-sent only when the
+     * delta leaves [0, 65535] or after a reconnect:
+     *   [seriesId_len:u8 | seriesId_bytes | y:float_LE | dt:u16_LE]
+     *
+     * @param sampleMillis local millis() at which `y` was sampled
+     */
+    AdvancedChartWidget& addPointAt(const char* seriesId, float y, uint32_t sampleMillis) {
+        uint64_t t = _sender.serverTimeMs(sampleMillis);
+        if (t == 0) return addPoint(seriesId, y);
+
+        if (_timeBase == 0 || t < _timeBase || t - _timeBase > 0xFFFF) {
+            uint8_t base[8];
+            writeU64LE(base, t);
+            if (!sendBinary(EV_SETTIMEBASE, base, 8)) return *this;
+            _timeBase = t;
+        }
+
+        uint8_t buf[64]; size_t b = 0;
+        b += writeString(buf+b, seriesId, sizeof(buf) - 7);
+        writeFloatLE(buf+b, y); b += 4;
+        writeU16LE(buf+b, (uint16_t)(t - _timeBase)); b += 2;
+        sendBinary(EV_ADDPOINT_TS, buf, b);
+        _pointIndex++;
+        return *this;
+    }
+
+    AdvancedChartWidget& addPointNow(const char* seriesId, float y) {
+        return addPointAt(seriesId, y, millis());
+    }
+
+    /** Forces the time base to be re-sent with the next timestamped point. */
+    void invalidateTimeBase() { _timeBase = 0; }
+
     /**
      * Push a complete data series in one frame. Useful for boot-time
      * restoration or batch updates from a local buffer.
@@ -42,12 +149,13 @@ public:
      *   [seriesId_len:u8 | seriesId_bytes | count:u16_LE | points×float_LE]
      */
     AdvancedChartWidget& setSeriesData(const char* seriesId, const float* points, uint16_t count) {
-        // Reasonable bounds: do not exceed TX buffer
-        if (count > 200) count = 200; // 200 * 4 + ~32 = ~832 bytes max payload
-        uint8_t buf[1024];
+        // One frame by design (it replaces the series): keep what fits
+        uint8_t buf[INSTANT_TX_BUFFER_SIZE];
         size_t p = 0;
         size_t sidLen = seriesId ? strlen(seriesId) : 0;
         if (sidLen > 255) sidLen = 255;
+        const size_t fit = pointsPerFrame(1 + sidLen + 2, 4, sizeof(buf));
+        if (count > fit) count = (uint16_t)fit;
         buf[p++] = (uint8_t)sidLen;
         if (sidLen) { memcpy(buf + p, seriesId, sidLen); p += sidLen; }
         buf[p++] = (uint8_t)(count & 0xFF);
@@ -65,19 +173,129 @@ public:
     }
 
     AdvancedChartWidget& clearSeries(const char* seriesId) {
+        #if INSTANTIOT_CHART_HISTORY
+        if (ChartSeries* s = findSeries(seriesId, false)) s->clear();
+        #endif
         uint8_t buf[32];
-        size_t n = writeString(buf, seriesId);
+        size_t n = writeString(buf, seriesId, sizeof(buf) - 1);
         sendBinary(EV_CLEARSERIES, buf, n);
         return *this;
     }
 
     AdvancedChartWidget& clear() {
         _pointIndex = 0;
+        #if INSTANTIOT_CHART_HISTORY
+        for (uint8_t i = 0; i < INSTANTIOT_CHART_SERIES; i++) _series[i].clear();
+        #endif
         sendBinary(EV_CLEARALL);
         return *this;
     }
 
     AdvancedChartWidget& resetIndex() { _pointIndex = 0; return *this; }
+
+private:
+    // Items of `itemSize` bytes that fit one frame after `head` bytes
+    size_t pointsPerFrame(size_t head, size_t itemSize, size_t bufSize) const {
+        size_t room = maxPayload();
+        if (room > bufSize) room = bufSize;
+        if (room <= head) return 0;
+        const size_t n = (room - head) / itemSize;
+        return n > 0xFFFF ? 0xFFFF : n;
+    }
+
+public:
+
+    #if INSTANTIOT_CHART_HISTORY
+    // ─── Buffered series (see ChartSeries.hpp) ────────────────
+
+    /**
+     * Reducer / window of `seriesId`, created on first use. When the
+     * INSTANTIOT_CHART_SERIES slots are taken, returns a blank sink that
+     * no chart reads: `used()` is false, and its settings are dropped.
+     */
+    ChartSeries& series(const char* seriesId) {
+        if (ChartSeries* s = findSeries(seriesId, true)) return *s;
+        IIOT_LOG_VAL("[Chart] No series slot left for ", seriesId ? seriesId : "default");
+        static ChartSeries sink;
+        sink = ChartSeries();       // nothing carries over between callers
+        return sink;
+    }
+
+    /**
+     * Raw sample: kept in the series window, sent as its reducer
+     * decides (REDUCE_NONE by default = sent now, like addPoint).
+     * Series beyond INSTANTIOT_CHART_SERIES fall back to addPoint.
+     */
+    AdvancedChartWidget& push(const char* seriesId, float y) {
+        ChartSeries* s = findSeries(seriesId, true);
+        if (!s) return addPoint(seriesId, y);
+        float out[2];
+        const uint8_t n = s->add(y, millis(), out);
+        for (uint8_t i = 0; i < n; i++) addPoint(s->id(), out[i]);
+        return *this;
+    }
+
+    AdvancedChartWidget& push(float y) { return push("default", y); }
+
+    /**
+     * Re-sends the window of every buffered series with setSeriesData,
+     * LTTB-downsampled to INSTANTIOT_CHART_RESTORE_POINTS. Runs after
+     * each connect edge with INSTANTIOT_STATE_RESYNC.
+     */
+    AdvancedChartWidget& restore() {
+        for (uint8_t i = 0; i < INSTANTIOT_CHART_SERIES; i++) {
+            const ChartSeries& s = _series[i];
+            if (!s.used() || s.size() == 0) continue;
+            float raw[ChartSeries::WINDOW];
+            float pts[INSTANTIOT_CHART_RESTORE_POINTS];
+            const size_t n = s.copyWindow(raw);
+            const size_t m = lttbDownsample(raw, n, pts, INSTANTIOT_CHART_RESTORE_POINTS);
+            setSeriesData(s.id(), pts, (uint16_t)m);
+        }
+        return *this;
+    }
+
+    // Buckets whose time is up, without waiting for the next sample —
+    // called by the core from loop()
+    void tick(uint32_t now) {
+        for (uint8_t i = 0; i < INSTANTIOT_CHART_SERIES; i++) {
+            ChartSeries& s = _series[i];
+            if (!s.used()) continue;
+            float out[2];
+            const uint8_t n = s.poll(now, out);
+            for (uint8_t k = 0; k < n; k++) addPoint(s.id(), out[k]);
+        }
+    }
+
+    uint32_t dueInMs(uint32_t now) const {
+        uint32_t due = UINT32_MAX;
+        for (uint8_t i = 0; i < INSTANTIOT_CHART_SERIES; i++) {
+            if (!_series[i].used()) continue;
+            const uint32_t d = _series[i].dueInMs(now);
+            if (d < due) due = d;
+        }
+        return due;
+    }
+
+    #if INSTANTIOT_STATE_RESYNC
+    void resync() override { restore(); }
+    #endif
+
+private:
+    ChartSeries* findSeries(const char* seriesId, bool create) {
+        if (!seriesId) seriesId = "default";
+        ChartSeries* freeSlot = nullptr;
+        for (uint8_t i = 0; i < INSTANTIOT_CHART_SERIES; i++) {
+            if (!_series[i].used()) { if (!freeSlot) freeSlot = &_series[i]; continue; }
+            if (strcmp(_series[i].id(), seriesId) == 0) return &_series[i];
+        }
+        if (!create || !freeSlot) return nullptr;
+        freeSlot->assign(seriesId);
+        return freeSlot;
+    }
+
+    ChartSeries _series[INSTANTIOT_CHART_SERIES];
+    #endif
 };
 
 } // namespace InstantIoT
\ No newline at end of file
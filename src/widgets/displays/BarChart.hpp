@@ -23,7 +23,9 @@ namespace InstantIoT {
  *   instant.barChart("env").setValues(values, 3);
  *
  * Memory: ~16 bytes per instance + 4×count in buffer for
- * setValues. No dynamic allocation.
+ * setValues. No dynamic allocation. With INSTANTIOT_BAR_DELTA the
+ * widget keeps the app's copy of the bars (+256 B) and setValues()
+ * only sends the bars that changed (see sendDelta()).
  */
 class BarChartWidget : public DisplayWidget {
 public:
@@ -39,18 +41,28 @@ public:
      *
      * @param values pointer to `count` floats
      * @param count number of values (must be ≥ 1, max 64
-     *              to fit in the codec's 256B buffer)
+     *              to fit INSTANT_TX_BUFFER_SIZE)
      */
     BarChartWidget& setValues(const float* values, uint8_t count) {
         if (count == 0 || values == nullptr) return *this;
         if (count > 64) count = 64;  // cap to stay within buffer
 
+        #if INSTANTIOT_BAR_DELTA
+        sendDelta(values, count);
+        #else
+        #if INSTANTIOT_STATE_RESYNC
+        _barCount = count;                     // may exceed the copy: see resync()
+        if (values != _bars) memcpy(_bars, values, (count < SHADOW_BARS ? count : SHADOW_BARS) * sizeof(float));
+        _cleared = false;
+        #endif
+
         uint8_t buf[1 + 64 * 4];
         buf[0] = count;
         for (uint8_t i = 0; i < count; i++) {
             writeFloatLE(buf + 1 + i * 4, values[i]);
         }
         sendBinary(EV_BAR_SETVALUES, buf, 1 + count * 4);
+        #endif
         return *this;
     }
 
@@ -61,10 +73,27 @@ public:
      * on the app side, the frame is silently ignored.
      */
     BarChartWidget& setBar(uint8_t index, float value) {
+        #if INSTANTIOT_BAR_DELTA || INSTANTIOT_STATE_RESYNC
+        if (index < SHADOW_BARS) {
+            #if INSTANTIOT_BAR_DELTA
+            if (index >= _barCount) _peerSynced = false;   // bar count now unsure
+            #endif
+            while (_barCount <= index) _bars[_barCount++] = 0;   // unknown bars: 0
+            _bars[index] = value;
+            _cleared = false;
+        } else if (_barCount <= index) {
+            _barCount = (uint8_t)(index + 1);                    // beyond the copy
+        }
+        #endif
         uint8_t buf[5];
         buf[0] = index;
         writeFloatLE(buf + 1, value);
-        sendBinary(EV_BAR_SETBAR, buf, 5);
+        const bool ok = sendBinary(EV_BAR_SETBAR, buf, 5);
+        #if INSTANTIOT_BAR_DELTA
+        if (!ok) _peerSynced = false;   // the app missed this bar
+        #else
+        (void)ok;
+        #endif
         return *this;
     }
 
@@ -73,9 +102,155 @@ public:
      * or on user reset.
      */
     BarChartWidget& clear() {
+        #if INSTANTIOT_BAR_DELTA || INSTANTIOT_STATE_RESYNC
+        _barCount = 0; _cleared = true;
+        #endif
+        #if INSTANTIOT_BAR_DELTA
+        _peerSynced = false;
+        #endif
         sendBinary(EV_BAR_CLEAR);
         return *this;
     }
+
+    #if INSTANTIOT_BAR_DELTA
+    /**
+     * Quantizes delta values to `bits` (8 or 16) over [min, max]:
+     * 1 or 2 bytes per changed bar instead of 4, and moves smaller
+     * than one step are not sent at all. bits = 0 turns it off.
+     */
+    BarChartWidget& setQuantization(float min, float max, uint8_t bits = 8) {
+        _qBits = (bits == 8 || bits == 16) && max > min ? bits : 0;
+        _qMin  = min;
+        _qMax  = max;
+        _peerSynced = false;
+        return *this;
+    }
+
+    /** Next setValues() sends every bar (called on each connect edge). */
+    void invalidateDelta() { _peerSynced = false; }
+    #endif
+
+    #if INSTANTIOT_STATE_RESYNC
+    // A chart with more bars than the copy holds is not re-sent:
+    // a shortened array would drop the app's extra bars
+    void resync() override {
+        #if INSTANTIOT_BAR_DELTA
+        _peerSynced = false;
+        #endif
+        if (_barCount > SHADOW_BARS) return;
+        if (_barCount) setValues(_bars, _barCount);
+        else if (_cleared) clear();
+    }
+    #endif
+
+private:
+    #if INSTANTIOT_BAR_DELTA
+    static const uint8_t SHADOW_BARS = 64;     // deltas compare every bar
+    #elif INSTANTIOT_STATE_RESYNC
+    static const uint8_t SHADOW_BARS = INSTANTIOT_RESYNC_MAX_BARS;
+    #endif
+
+    #if INSTANTIOT_BAR_DELTA || INSTANTIOT_STATE_RESYNC
+    float   _bars[SHADOW_BARS];    // last values set (as the app shows them)
+    uint8_t _barCount = 0;         // bars the app shows, may exceed SHADOW_BARS
+    bool    _cleared  = false;
+    #endif
+
+    #if INSTANTIOT_BAR_DELTA
+    bool    _peerSynced = false;   // the app holds _bars[0.._barCount)
+    uint8_t _qBits = 0;
+    float   _qMin = 0, _qMax = 0;
+
+    uint16_t quantize(float v) const {
+        const uint16_t top = _qBits == 16 ? 0xFFFF : 0xFF;
+        if (!(v > _qMin)) return 0;      // NaN too
+        if (v >= _qMax) return top;
+        return (uint16_t)((v - _qMin) / (_qMax - _qMin) * top + 0.5f);
+    }
+
+    float dequantize(uint16_t q) const {
+        const uint16_t top = _qBits == 16 ? 0xFFFF : 0xFF;
+        return _qMin + (_qMax - _qMin) * (float)q / (float)top;
+    }
+
+    bool changed(uint8_t i, float v) const {
+        if (_qBits) return quantize(v) != quantize(_bars[i]);
+        return memcmp(&v, &_bars[i], sizeof(float)) != 0;
+    }
+
+    /**
+     * Sends what changed since the app's copy, in the smallest of:
+     *   EV_BAR_SETVALUES    1 + 4n
+     *   EV_BAR_SETBAR       5                        (one bar changed)
+     *   EV_BAR_SETMASKED    1 + ⌈n/8⌉ + 4k
+     *   EV_BAR_SETMASKED_Q  1 + ⌈n/8⌉ + 9 + (bits/8)·k   (quantization on)
+     * n = bars, k = changed bars. Everything counts as changed after a
+     * failed send, a connect edge or a different bar count.
+     */
+    void sendDelta(const float* values, uint8_t count) {
+        const bool full = !_peerSynced || count != _barCount;
+        const uint8_t maskLen = (uint8_t)((count + 7) / 8);
+        uint8_t mask[8] = {0};
+        uint8_t k = 0, one = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!full && !changed(i, values[i])) continue;
+            mask[i >> 3] |= (uint8_t)(1 << (i & 7));
+            k++;
+            one = i;
+        }
+        if (k == 0) return;
+
+        enum { FULL, BAR, MASKED, MASKED_Q } enc = FULL;
+        size_t best = 1 + 4 * (size_t)count;
+        if (!full && k == 1 && 5 < best)              { enc = BAR;      best = 5; }
+        if (1 + maskLen + 4 * (size_t)k < best)       { enc = MASKED;   best = 1 + maskLen + 4 * (size_t)k; }
+        const size_t qSize = 1 + maskLen + 9 + (size_t)(_qBits / 8) * k;
+        if (_qBits && qSize < best)                   { enc = MASKED_Q; best = qSize; }
+
+        uint8_t buf[1 + 64 * 4];
+        size_t b = 0;
+        bool ok;
+        switch (enc) {
+            case BAR:
+                buf[b++] = one;
+                writeFloatLE(buf + b, values[one]); b += 4;
+                ok = sendBinary(EV_BAR_SETBAR, buf, b);
+                break;
+            case MASKED:
+            case MASKED_Q:
+                buf[b++] = count;
+                memcpy(buf + b, mask, maskLen); b += maskLen;
+                if (enc == MASKED_Q) {
+                    buf[b++] = _qBits;
+                    writeFloatLE(buf + b, _qMin); b += 4;
+                    writeFloatLE(buf + b, _qMax); b += 4;
+                }
+                for (uint8_t i = 0; i < count; i++) {
+                    if (!(mask[i >> 3] & (1 << (i & 7)))) continue;
+                    if (enc == MASKED) { writeFloatLE(buf + b, values[i]); b += 4; continue; }
+                    const uint16_t q = quantize(values[i]);
+                    buf[b++] = (uint8_t)q;
+                    if (_qBits == 16) buf[b++] = (uint8_t)(q >> 8);
+                }
+                ok = sendBinary(enc == MASKED ? EV_BAR_SETMASKED : EV_BAR_SETMASKED_Q, buf, b);
+                break;
+            default:
+                buf[b++] = count;
+                for (uint8_t i = 0; i < count; i++) { writeFloatLE(buf + b, values[i]); b += 4; }
+                ok = sendBinary(EV_BAR_SETVALUES, buf, b);
+                break;
+        }
+
+        // Shadow = what the app now shows (quantized values as decoded)
+        for (uint8_t i = 0; i < count; i++) {
+            if (!(mask[i >> 3] & (1 << (i & 7)))) continue;
+            _bars[i] = enc == MASKED_Q ? dequantize(quantize(values[i])) : values[i];
+        }
+        _barCount   = count;
+        _cleared    = false;
+        _peerSynced = ok;
+    }
+    #endif
 };
 
 } // namespace InstantIoT
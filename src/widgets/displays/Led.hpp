@@ -2,9 +2,19 @@
 #include <Arduino.h>
 #include "../WidgetBase.hpp"
 #include "../../core/BinaryCodec.hpp"
+#include "../../utils/InstantIoTColor.hpp"
 
 namespace InstantIoT {
 
+// Animations run by the app from one EV_LED_ANIMATE descriptor
+enum LedAnimation : uint8_t {
+    LED_ANIM_NONE,      // stops the running animation
+    LED_ANIM_BLINK,     // palette[0] on / off, param = duty %
+    LED_ANIM_BREATHE,   // palette[0], brightness eased param % ↔ 100 %
+    LED_ANIM_FADE,      // palette[0] → palette[1] once, then holds
+    LED_ANIM_CYCLE,     // palette in turn, param 1 = smooth, 0 = steps
+};
+
 class LedWidget : public DisplayWidget {
 public:
     LedWidget(const char* id, IMessageSender& sender)
@@ -13,9 +23,21 @@ public:
     uint8_t getTypeCode() const override { return TYPE_LED; }
 
     // ── On / Off / Toggle ─────────────────────────────────────
-    LedWidget& On()     { sendBinary(0x01); return *this; }
-    LedWidget& Off()    { sendBinary(0x02); return *this; }
-    LedWidget& toggle() { sendBinary(0x03); return *this; }
+    // Any static command also ends the animation on the app side
+    #if INSTANTIOT_STATE_RESYNC
+    LedWidget& On()     { endAnimation(); _power = POWER_ON;  sendBinary(0x01); return *this; }
+    LedWidget& Off()    { endAnimation(); _power = POWER_OFF; sendBinary(0x02); return *this; }
+    LedWidget& toggle() {
+        endAnimation();
+        if (_power != POWER_UNKNOWN) _power = (_power == POWER_ON) ? POWER_OFF : POWER_ON;
+        sendBinary(0x03);
+        return *this;
+    }
+    #else
+    LedWidget& On()     { endAnimation(); sendBinary(0x01); return *this; }
+    LedWidget& Off()    { endAnimation(); sendBinary(0x02); return *this; }
+    LedWidget& toggle() { endAnimation(); sendBinary(0x03); return *this; }
+    #endif
 
     // Lowercase aliases for example compatibility
     LedWidget& on()     { return On(); }
@@ -25,6 +47,10 @@ public:
 
     // ── Brightness ────────────────────────────────────────────
     LedWidget& setBrightness(uint8_t v) {
+        endAnimation();
+        #if INSTANTIOT_STATE_RESYNC
+        _brightness = v; _known |= KNOWN_BRIGHTNESS;
+        #endif
         sendBinary(EV_SETBRIGHTNESS, &v, 1);
         return *this;
     }
@@ -38,6 +64,10 @@ public:
     // ── Color ─────────────────────────────────────────────────
     LedWidget& setColor(uint8_t r, uint8_t g, uint8_t b) {
         uint8_t buf[3] = {r, g, b};
+        endAnimation();
+        #if INSTANTIOT_STATE_RESYNC
+        memcpy(_rgb, buf, 3); _known |= KNOWN_COLOR;
+        #endif
         sendBinary(EV_SETCOLOR, buf, 3);
         return *this;
     }
@@ -46,11 +76,76 @@ public:
         return setColor((rgb>>16)&0xFF, (rgb>>8)&0xFF, rgb&0xFF);
     }
 
+    LedWidget& setColor(const Color& c) { return setColor(c.r, c.g, c.b); }
+
     // Alias setColors — in proto v1 we only send the led color
     LedWidget& setColors(uint32_t led, uint32_t /*halo*/, uint32_t /*rays*/) {
         return setColor(led);
     }
 
+    // ── Animations ────────────────────────────────────────────
+    // One descriptor frame; the app animates locally until the next
+    // LED command. Re-sending the running animation is a no-op.
+    // repeat = number of periods, 0 = forever.
+
+    LedWidget& blink(const Color& c, uint16_t periodMs, uint8_t dutyPct = 50, uint8_t repeat = 0) {
+        return animate(LED_ANIM_BLINK, &c, 1, periodMs, dutyPct, repeat);
+    }
+
+    LedWidget& breathe(const Color& c, uint16_t periodMs, uint8_t minPct = 0, uint8_t repeat = 0) {
+        return animate(LED_ANIM_BREATHE, &c, 1, periodMs, minPct, repeat);
+    }
+
+    /** from → to over `durationMs`, then stays on `to`. */
+    LedWidget& fade(const Color& from, const Color& to, uint16_t durationMs) {
+        const Color pair[2] = {from, to};
+        return animate(LED_ANIM_FADE, pair, 2, durationMs, 0, 1);
+    }
+
+    /** Walks `palette` once per period, blended or in steps. */
+    LedWidget& colorCycle(const Color* palette, uint8_t count, uint16_t periodMs,
+                          bool smooth = true, uint8_t repeat = 0) {
+        return animate(LED_ANIM_CYCLE, palette, count, periodMs, smooth ? 1 : 0, repeat);
+    }
+
+    LedWidget& stopAnimation() { return animate(LED_ANIM_NONE, nullptr, 0, 0, 0, 0); }
+
+    /** Raw descriptor; palette clipped to ANIM_MAX_COLORS. */
+    LedWidget& animate(LedAnimation kind, const Color* palette, uint8_t count,
+                       uint16_t periodMs, uint8_t param, uint8_t repeat) {
+        if (count > ANIM_MAX_COLORS) count = ANIM_MAX_COLORS;
+        uint8_t buf[ANIM_HEADER + 3 * ANIM_MAX_COLORS];
+        buf[0] = kind;
+        writeU16LE(buf + 1, periodMs);
+        buf[3] = repeat;
+        buf[4] = param;
+        buf[5] = count;
+        for (uint8_t i = 0; i < count; i++) {
+            buf[ANIM_HEADER + 3 * i]     = palette[i].r;
+            buf[ANIM_HEADER + 3 * i + 1] = palette[i].g;
+            buf[ANIM_HEADER + 3 * i + 2] = palette[i].b;
+        }
+        const size_t len = ANIM_HEADER + 3 * count;
+        const uint32_t h = kind == LED_ANIM_NONE ? 0 : payloadHash(buf, len);
+        // Endless one already running (or already stopped): nothing to do.
+        // A finite one may have ended on the app: always sent
+        if (repeat == 0 && h == _animHash) return *this;
+        if (!sendBinary(EV_LED_ANIMATE, buf, len)) return *this;
+        _animHash = h;
+        #if INSTANTIOT_STATE_RESYNC
+        // Endless: replayed by resync(). Finite: only its end state stays
+        _animLen = (repeat == 0 && kind != LED_ANIM_NONE) ? (uint8_t)len : 0;
+        if (_animLen) memcpy(_anim, buf, len);
+        if (kind == LED_ANIM_FADE && count == 2) {
+            memcpy(_rgb, buf + ANIM_HEADER + 3, 3); _known |= KNOWN_COLOR;
+        }
+        #endif
+        return *this;
+    }
+
+    /** The app lost its animation (new peer): next animate() is sent. */
+    void invalidateAnimation() { _animHash = 0; }
+
     // ── setState ──────────────────────────────────────────────
     LedWidget& setState(bool on, float intensity = 1.0f) {
         if (on) { setIntensity(intensity); On(); }
@@ -62,6 +157,41 @@ public:
     // Not supported in binary protocol v1 — no-op for compatibility
     LedWidget& showHalo(bool) { return *this; }
     LedWidget& showRays(bool) { return *this; }
+
+    #if INSTANTIOT_STATE_RESYNC
+    void resync() override {
+        if (_known & KNOWN_COLOR)      sendBinary(EV_SETCOLOR, _rgb, 3);
+        if (_known & KNOWN_BRIGHTNESS) sendBinary(EV_SETBRIGHTNESS, &_brightness, 1);
+        if (_power != POWER_UNKNOWN)   sendBinary(_power == POWER_ON ? 0x01 : 0x02);
+        if (_animLen && sendBinary(EV_LED_ANIMATE, _anim, _animLen))
+            _animHash = payloadHash(_anim, _animLen);   // running again: same animate() is a no-op
+    }
+    #endif
+
+private:
+    static const uint8_t ANIM_HEADER     = 6;
+    static const uint8_t ANIM_MAX_COLORS = 8;
+
+    // A static command replaces the animation on the app
+    void endAnimation() {
+        _animHash = 0;
+        #if INSTANTIOT_STATE_RESYNC
+        _animLen = 0;
+        #endif
+    }
+
+    uint32_t _animHash = 0;     // descriptor running on the app, 0 = none
+
+    #if INSTANTIOT_STATE_RESYNC
+    enum : uint8_t { POWER_UNKNOWN, POWER_ON, POWER_OFF };  // toggle() before On/Off: unknown
+    enum : uint8_t { KNOWN_COLOR = 0x01, KNOWN_BRIGHTNESS = 0x02 };
+    uint8_t _power = POWER_UNKNOWN;
+    uint8_t _known = 0;
+    uint8_t _brightness = 0;
+    uint8_t _rgb[3] = {0, 0, 0};
+    uint8_t _anim[ANIM_HEADER + 3 * ANIM_MAX_COLORS];
+    uint8_t _animLen = 0;       // endless animation to replay
+    #endif
 };
 
 } // namespace InstantIoT
\ No newline at end of file
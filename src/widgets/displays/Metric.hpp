@@ -14,19 +14,38 @@ public:
 
     // ── Numeric value only ────────────────────────────────────
     MetricWidget& setValue(float value) {
-        uint8_t buf[4]; writeFloatLE(buf, value);
-        sendBinary(EV_SETVALUE, buf, 4);
+        #if INSTANTIOT_STATE_RESYNC
+        _value = value; _hasValue = true;
+        #endif
+        sendFilteredFloat(EV_SETVALUE, value);
         return *this;
     }
 
     // ── String value + label ──────────────────────────────────
     MetricWidget& setSecondaryValue(const char* val, const char* label) {
         uint8_t buf[80]; size_t b = 0;
-        b += writeString(buf+b, val);
-        b += writeString(buf+b, label);
+        b += writeString(buf+b, val, sizeof(buf) / 2 - 1);
+        b += writeString(buf+b, label, sizeof(buf) - b - 1);
+        #if INSTANTIOT_STATE_RESYNC
+        _secondaryLen = b <= sizeof(_secondary) ? (uint8_t)b : 0;   // too long: not kept
+        memcpy(_secondary, buf, _secondaryLen);
+        #endif
         sendBinary(EV_SETSECONDARY, buf, b);
         return *this;
     }
+
+    #if INSTANTIOT_STATE_RESYNC
+    void resync() override {
+        if (_hasValue) { _filter.reset(); setValue(_value); }
+        if (_secondaryLen) sendBinary(EV_SETSECONDARY, _secondary, _secondaryLen);
+    }
+
+private:
+    float   _value = 0;
+    bool    _hasValue = false;
+    uint8_t _secondaryLen = 0;
+    uint8_t _secondary[INSTANTIOT_RESYNC_TEXT_LENGTH];   // encoded payload
+    #endif
 };
 
 } // namespace InstantIoT
\ No newline at end of file
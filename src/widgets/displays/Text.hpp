@@ -1,23 +1,154 @@
 #pragma once
 #include <Arduino.h>
+#include <stdarg.h>
 #include "../WidgetBase.hpp"
 #include "../../core/BinaryCodec.hpp"
+#include "../../utils/InstantIoTFormat.hpp"
 
 namespace InstantIoT {
 
 class TextWidget : public DisplayWidget {
 public:
+    // Longest text one frame carries ([len:u8]); clipped further to the
+    // frame room left by the ids
+    static const size_t MAX_TEXT = INSTANT_TX_BUFFER_SIZE < 255 ? INSTANT_TX_BUFFER_SIZE : 255;
+
     TextWidget(const char* id, IMessageSender& sender)
         : DisplayWidget(id, sender) {}
 
     uint8_t getTypeCode() const override { return TYPE_TEXT; }
 
+    // Unchanged text is not re-sent (FNV-1a of the last text sent)
     TextWidget& setText(const char* text) {
-        uint8_t buf[129];
-        size_t n = writeString(buf, text);
-        sendBinary(EV_SETTEXT, buf, n);
+        uint8_t buf[HEAD + MAX_TEXT];
+        size_t n = 0;
+        if (text) while (n < MAX_TEXT && text[n]) n++;
+        if (n) memcpy(buf + HEAD, text, n);
+        sendText(buf, n);
+        return *this;
+    }
+
+    /** printf-style, no heap (see utils/InstantIoTFormat.hpp). */
+    TextWidget& setTextf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        uint8_t buf[HEAD + MAX_TEXT + 1];      // + the formatter's NUL
+        va_list ap;
+        va_start(ap, fmt);
+        const size_t n = vformatTo((char*)buf + HEAD, MAX_TEXT + 1, fmt, ap);
+        va_end(ap);
+        sendText(buf, n);
+        return *this;
+    }
+
+    #if INSTANTIOT_TEXT_DELTA
+    /**
+     * Appends to the text the app shows (log panes): only `text` is
+     * sent. The app may hold more than MAX_TEXT; the next setText()
+     * then replaces it all.
+     */
+    TextWidget& appendText(const char* text) {
+        uint8_t buf[1 + MAX_TEXT];
+        const size_t room = maxPayload();
+        const size_t n = writeString(buf, text, room > 1 ? room - 1 : 0) - 1;
+        if (n == 0 || !sendBinary(EV_TEXT_APPEND, buf, 1 + n)) return *this;
+        if (_peerSynced && _shadow[0] + n <= MAX_TEXT) {
+            memcpy(_shadow + 1 + _shadow[0], buf + 1, n);
+            _shadow[0] += (uint8_t)n;
+            _hash = payloadHash(_shadow + 1, _shadow[0]);
+        } else {
+            _hasShadow  = false;        // the app's text is no longer known
+            _peerSynced = false;
+            _hash       = 0;
+        }
         return *this;
     }
+    #endif
+
+    /** The app lost its text (new peer): the next setText() is sent. */
+    void invalidateText() {
+        _hash = 0;
+        #if INSTANTIOT_TEXT_DELTA
+        _peerSynced = false;
+        #endif
+    }
+
+    #if INSTANTIOT_STATE_RESYNC
+    void resync() override {
+        #if INSTANTIOT_TEXT_DELTA
+        if (!_hasShadow) return;
+        _peerSynced = sendBinary(EV_SETTEXT, _shadow, 1 + _shadow[0]);
+        if (_peerSynced) _hash = payloadHash(_shadow + 1, _shadow[0]);
+        #else
+        if (_textLen && sendBinary(EV_SETTEXT, _text, _textLen))
+            _hash = payloadHash(_text + 1, _textLen - 1);
+        #endif
+    }
+    #endif
+
+private:
+    // Room before the text for the largest header: [start][delete][len]
+    static const size_t HEAD = 3;
+
+    // Text at buf + HEAD, n bytes; headers are written in place before it
+    void sendText(uint8_t* buf, size_t n) {
+        const size_t room = maxPayload();
+        if (n + 1 > room) n = room ? room - 1 : 0;
+        uint8_t* t = buf + HEAD;
+        const uint32_t h = payloadHash(t, n);
+        if (h == _hash) return;
+
+        #if INSTANTIOT_STATE_RESYNC && !INSTANTIOT_TEXT_DELTA
+        _textLen = n + 1 <= sizeof(_text) ? (uint8_t)(n + 1) : 0;   // too long: not kept
+        if (_textLen) { _text[0] = (uint8_t)n; memcpy(_text + 1, t, n); }
+        #endif
+
+        uint8_t  ev  = EV_SETTEXT;
+        uint8_t* out = t - 1;
+        size_t   len = 1 + n;
+        #if INSTANTIOT_TEXT_DELTA
+        if (_peerSynced) {
+            // Only the middle differs: common prefix p and suffix s
+            const size_t m = _shadow[0];
+            const uint8_t* old = _shadow + 1;
+            size_t p = 0, s = 0;
+            while (p < n && p < m && t[p] == old[p]) p++;
+            while (s < n - p && s < m - p && t[n - 1 - s] == old[m - 1 - s]) s++;
+            const size_t ins = n - p - s, del = m - p - s;
+            _shadow[0] = (uint8_t)n;
+            memcpy(_shadow + 1, t, n);          // before the headers overwrite t
+            if (del == 0 && s == 0 && 1 + ins < len) {
+                ev = EV_TEXT_APPEND;  out = t + p - 1;  len = 1 + ins;
+                out[0] = (uint8_t)ins;
+            } else if (3 + ins < len) {
+                ev = EV_TEXT_REPLACE; out = t + p - 3;  len = 3 + ins;
+                out[0] = (uint8_t)p; out[1] = (uint8_t)del; out[2] = (uint8_t)ins;
+            }
+        } else {
+            _shadow[0] = (uint8_t)n;
+            memcpy(_shadow + 1, t, n);
+        }
+        _hasShadow = true;
+        #endif
+        if (ev == EV_SETTEXT) out[0] = (uint8_t)n;
+
+        const bool ok = sendBinary(ev, out, len);
+        _hash = ok ? h : 0;
+        #if INSTANTIOT_TEXT_DELTA
+        _peerSynced = ok;                       // failed delta: app state unknown
+        #endif
+    }
+
+    uint32_t _hash = 0;                         // text last sent, 0 = none
+
+    #if INSTANTIOT_TEXT_DELTA
+    uint8_t _shadow[1 + MAX_TEXT];              // [len] + text the sketch last set
+    bool    _hasShadow  = false;
+    bool    _peerSynced = false;                // the app shows _shadow
+    #endif
+
+    #if INSTANTIOT_STATE_RESYNC && !INSTANTIOT_TEXT_DELTA
+    uint8_t _textLen = 0;
+    uint8_t _text[INSTANTIOT_RESYNC_TEXT_LENGTH];   // encoded payload
+    #endif
 };
 
-} // namespace InstantIoT
\ No newline at end of file
+} // namespace InstantIoT
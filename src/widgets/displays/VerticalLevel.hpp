@@ -13,23 +13,43 @@ public:
     uint8_t getTypeCode() const override { return TYPE_VLEVEL; }
 
     VerticalLevelWidget& setValue(float value) {
-        uint8_t buf[4]; writeFloatLE(buf, value);
-        sendBinary(EV_SETVALUE, buf, 4);
+        #if INSTANTIOT_STATE_RESYNC
+        _state.value = value; _state.hasValue = true;
+        #endif
+        sendFilteredFloat(EV_SETVALUE, value);
         return *this;
     }
 
     VerticalLevelWidget& setRange(float min, float max) {
+        #if INSTANTIOT_STATE_RESYNC
+        _state.min = min; _state.max = max; _state.hasRange = true;
+        #endif
         uint8_t buf[8]; writeFloatLE(buf, min); writeFloatLE(buf+4, max);
         sendBinary(EV_SETRANGE, buf, 8);
         return *this;
     }
 
     VerticalLevelWidget& update(float value, float min, float max) {
+        #if INSTANTIOT_STATE_RESYNC
+        _state.value = value; _state.min = min; _state.max = max;
+        _state.hasValue = _state.hasRange = true;
+        #endif
         uint8_t buf[12];
         writeFloatLE(buf, value); writeFloatLE(buf+4, min); writeFloatLE(buf+8, max);
-        sendBinary(EV_UPDATE, buf, 12);
+        if (sendBinary(EV_UPDATE, buf, 12)) _filter.sent(value);   // range change: never filtered
         return *this;
     }
+
+    #if INSTANTIOT_STATE_RESYNC
+    void resync() override {
+        if (_state.hasValue && _state.hasRange) update(_state.value, _state.min, _state.max);
+        else if (_state.hasRange) setRange(_state.min, _state.max);
+        else if (_state.hasValue) { _filter.reset(); setValue(_state.value); }
+    }
+
+private:
+    RangedValueState _state;
+    #endif
 };
 
 } // namespace InstantIoT
\ No newline at end of file